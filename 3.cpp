@@ -1,31 +1,467 @@
 #include <iostream>
 #include <string>
 #include <cctype>
-#include "structures_from_lr1.h"
+#include <cstdint>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <random>
+#include <array>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GENOME_SIMD_X86 1
+#endif
 
 using namespace std;
 
-// Специальное множество для пар (2 символа)
+// Количество различных пар заглавных латинских букв (26 * 26)
+const int PAIR_COUNT = 26 * 26;
+
+// Код пары: (первая буква - 'A') * 26 + (вторая буква - 'A')
+inline int pairCode(char first, char second) {
+    return (first - 'A') * 26 + (second - 'A');
+}
+
+// Специальное множество для пар (2 символа) - битовая таблица с прямой индексацией
 struct PairSet {
-    SetArray* pairs;
+    bool present[PAIR_COUNT];
     
     PairSet() {
-        pairs = createSet(100); // Начальная емкость 100
+        for (int i = 0; i < PAIR_COUNT; i++) {
+            present[i] = false;
+        }
+    }
+    
+    void insertCode(int code) {
+        present[code] = true;
     }
     
-    ~PairSet() {
-        destroySet(pairs);
+    bool containsCode(int code) const {
+        return present[code];
     }
     
     void insert(const string& pair) {
         if (pair.length() == 2) {
-            setInsert(pairs, pair);
+            insertCode(pairCode(pair[0], pair[1]));
         }
     }
     
-    bool contains(const string& pair) {
+    bool contains(const string& pair) const {
         if (pair.length() != 2) return false;
-        return setContains(pairs, pair);
+        return containsCode(pairCode(pair[0], pair[1]));
+    }
+};
+
+// Ядра проверки генома и подсчета пар. Векторные версии (AVX2, SSE4.1) выбираются
+// во время выполнения по возможностям процессора, скалярная - запасной вариант.
+// Ядра пар рассчитаны на уже проверенный геном (только 'A'-'Z').
+// Построение таблицы пар остается скалярным: без scatter запись кодов через буфер
+// оказывается медленнее прямой записи в таблицу.
+
+// Скалярное ядро: индекс первого символа вне 'A'-'Z' или length
+size_t findInvalidCharScalar(const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (static_cast<unsigned char>(data[i] - 'A') >= 26) return i;
+    }
+    return length;
+}
+
+void insertPairsScalar(PairSet& pairs, const char* data, size_t length) {
+    for (size_t i = 0; i + 1 < length; i++) {
+        pairs.insertCode(pairCode(data[i], data[i + 1]));
+    }
+}
+
+long long countPairsScalar(const PairSet& pairs, const char* data, size_t length) {
+    long long count = 0;
+    for (size_t i = 0; i + 1 < length; i++) {
+        count += pairs.containsCode(pairCode(data[i], data[i + 1]));
+    }
+    return count;
+}
+
+#ifdef GENOME_SIMD_X86
+__attribute__((target("sse4.1")))
+size_t findInvalidCharSse4(const char* data, size_t length) {
+    const __m128i base = _mm_set1_epi8('A');
+    const __m128i maxLetter = _mm_set1_epi8(25);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i letters = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), base);
+        __m128i valid = _mm_cmpeq_epi8(_mm_min_epu8(letters, maxLetter), letters);
+        int invalidMask = ~_mm_movemask_epi8(valid) & 0xFFFF;
+        if (invalidMask) return i + __builtin_ctz(invalidMask);
+    }
+    return i + findInvalidCharScalar(data + i, length - i);
+}
+
+// Коды 16 пар, начиная с data: (c[i]-'A')*26 + (c[i+1]-'A'), по 16 бит
+__attribute__((target("sse4.1")))
+inline void pairCodesSse4(const char* data, __m128i& low, __m128i& high) {
+    const __m128i base = _mm_set1_epi8('A');
+    const __m128i factor = _mm_set1_epi16(26);
+    __m128i first = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), base);
+    __m128i second = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 1)), base);
+    low = _mm_add_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(first), factor), _mm_cvtepu8_epi16(second));
+    high = _mm_add_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(first, 8)), factor),
+                         _mm_cvtepu8_epi16(_mm_srli_si128(second, 8)));
+}
+
+// SSE не умеет gather, поэтому коды пачкой сохраняются и проверяются по таблице
+__attribute__((target("sse4.1")))
+long long countPairsSse4(const PairSet& pairs, const char* data, size_t length) {
+    alignas(16) uint16_t codes[16];
+    long long count = 0;
+    size_t i = 0;
+    for (; i + 17 <= length; i += 16) {
+        __m128i low, high;
+        pairCodesSse4(data + i, low, high);
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes), low);
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes + 8), high);
+        int batch = 0;
+        for (int j = 0; j < 16; j++) {
+            batch += pairs.containsCode(codes[j]);
+        }
+        count += batch;
+    }
+    return count + countPairsScalar(pairs, data + i, length - i);
+}
+
+__attribute__((target("avx2")))
+size_t findInvalidCharAvx2(const char* data, size_t length) {
+    const __m256i base = _mm256_set1_epi8('A');
+    const __m256i maxLetter = _mm256_set1_epi8(25);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i letters = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), base);
+        __m256i valid = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, maxLetter), letters);
+        uint32_t invalidMask = ~static_cast<uint32_t>(_mm256_movemask_epi8(valid));
+        if (invalidMask) return i + __builtin_ctz(invalidMask);
+    }
+    return i + findInvalidCharScalar(data + i, length - i);
+}
+
+// Коды 32 пар, начиная с data, по 16 бит
+__attribute__((target("avx2")))
+inline void pairCodesAvx2(const char* data, __m256i& low, __m256i& high) {
+    const __m256i base = _mm256_set1_epi8('A');
+    const __m256i factor = _mm256_set1_epi16(26);
+    __m256i first = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), base);
+    __m256i second = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 1)), base);
+    low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(first)), factor),
+                           _mm256_cvtepu8_epi16(_mm256_castsi256_si128(second)));
+    high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(first, 1)), factor),
+                            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(second, 1)));
+}
+
+// Проверка по таблице пачками по 8 пар через gather из копии таблицы в int32
+__attribute__((target("avx2")))
+long long countPairsAvx2(const PairSet& pairs, const char* data, size_t length) {
+    alignas(32) int32_t table[PAIR_COUNT];
+    for (int i = 0; i < PAIR_COUNT; i++) {
+        table[i] = pairs.present[i];
+    }
+    
+    __m256i total = _mm256_setzero_si256();
+    long long count = 0;
+    size_t i = 0;
+    size_t sinceFlush = 0;
+    for (; i + 33 <= length; i += 32) {
+        __m256i low, high;
+        pairCodesAvx2(data + i, low, high);
+        __m256i hits = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(low)), 4),
+                             _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(low, 1)), 4)),
+            _mm256_add_epi32(_mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(high)), 4),
+                             _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(high, 1)), 4)));
+        total = _mm256_add_epi32(total, hits);
+        // Счетчики int32 сбрасываются в long long, пока не могут переполниться
+        if (++sinceFlush == (1u << 24)) {
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+            for (int j = 0; j < 8; j++) count += lanes[j];
+            total = _mm256_setzero_si256();
+            sinceFlush = 0;
+        }
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    for (int j = 0; j < 8; j++) count += lanes[j];
+    return count + countPairsScalar(pairs, data + i, length - i);
+}
+#endif
+
+// Набор ядер одного уровня оптимизации
+struct GenomeKernels {
+    const char* name;
+    size_t (*findInvalidChar)(const char* data, size_t length);
+    void (*insertPairs)(PairSet& pairs, const char* data, size_t length);
+    long long (*countPairs)(const PairSet& pairs, const char* data, size_t length);
+};
+
+// Все ядра, поддерживаемые текущим процессором, от лучшего к скалярному
+vector<GenomeKernels> availableGenomeKernels() {
+    vector<GenomeKernels> kernels;
+#ifdef GENOME_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(GenomeKernels{"avx2", findInvalidCharAvx2, insertPairsScalar, countPairsAvx2});
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        kernels.push_back(GenomeKernels{"sse4.1", findInvalidCharSse4, insertPairsScalar, countPairsSse4});
+    }
+#endif
+    kernels.push_back(GenomeKernels{"scalar", findInvalidCharScalar, insertPairsScalar, countPairsScalar});
+    return kernels;
+}
+
+// Ядра, выбранные для этого процессора (определяются один раз)
+const GenomeKernels& genomeKernels() {
+    static const GenomeKernels best = availableGenomeKernels().front();
+    return best;
+}
+
+// Допустимые длины k-меров
+const int MIN_K = 2;
+const int MAX_K = 31;
+// До этой длины множество k-меров хранится битовой таблицей (2^(5k) бит, не более 4 МБ)
+const int DIRECT_MAX_K = 5;
+
+// Упакованный k-мер: по 5 бит на букву ('A' -> 1 ... 'Z' -> 26), по 12 букв в слове
+const int KMER_WORDS = 3;
+const int LETTERS_PER_WORD = 12;
+const uint64_t WORD_MASK = (1ULL << (5 * LETTERS_PER_WORD)) - 1;
+
+struct KmerCode {
+    uint64_t w[KMER_WORDS];
+    
+    bool operator==(const KmerCode& other) const {
+        return w[0] == other.w[0] && w[1] == other.w[1] && w[2] == other.w[2];
+    }
+    
+    bool isEmpty() const {
+        return (w[0] | w[1] | w[2]) == 0;
+    }
+    
+    bool operator<(const KmerCode& other) const {
+        if (w[2] != other.w[2]) return w[2] < other.w[2];
+        if (w[1] != other.w[1]) return w[1] < other.w[1];
+        return w[0] < other.w[0];
+    }
+};
+
+// Скользящее окно по геному: код k-мера обновляется сдвигом на 5 бит, без подстрок.
+// Состояние переживает границы фрагментов, поэтому геном можно подавать по частям.
+struct KmerRoller {
+    int k;
+    int words;
+    int filled;
+    uint64_t mask[KMER_WORDS];
+    KmerCode code;
+    
+    KmerRoller(int kmerLength) : k(kmerLength) {
+        words = (k + LETTERS_PER_WORD - 1) / LETTERS_PER_WORD;
+        for (int j = 0; j < KMER_WORDS; j++) {
+            int letters = k - j * LETTERS_PER_WORD;
+            if (letters <= 0) {
+                mask[j] = 0;
+            } else if (letters >= LETTERS_PER_WORD) {
+                mask[j] = WORD_MASK;
+            } else {
+                mask[j] = (1ULL << (5 * letters)) - 1;
+            }
+        }
+        reset();
+    }
+    
+    void reset() {
+        filled = 0;
+        code.w[0] = code.w[1] = code.w[2] = 0;
+    }
+    
+    // Добавляет букву; возвращает true, когда в окне полный k-мер
+    bool push(char c) {
+        uint64_t letter = static_cast<uint64_t>(c - 'A' + 1);
+        if (words == 1) {
+            code.w[0] = ((code.w[0] << 5) | letter) & mask[0];
+        } else {
+            code.w[2] = ((code.w[2] << 5) | (code.w[1] >> 55)) & mask[2];
+            code.w[1] = ((code.w[1] << 5) | (code.w[0] >> 55)) & mask[1];
+            code.w[0] = ((code.w[0] << 5) | letter) & mask[0];
+        }
+        if (filled < k) filled++;
+        return filled == k;
+    }
+};
+
+inline uint64_t mixKmer(const KmerCode& code) {
+    uint64_t h = code.w[0] ^ (code.w[1] * 0x9E3779B97F4A7C15ULL) ^ (code.w[2] * 0xC2B2AE3D27D4EB4FULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Сколько 64-битных слов нужно k-меру: для k <= 12 код - одно uint64
+inline int kmerWords(int k) {
+    return (k + LETTERS_PER_WORD - 1) / LETTERS_PER_WORD;
+}
+
+// Сравнение хранимого кода из words слов с кодом окна (старшее слово - последнее)
+inline int compareKmer(const uint64_t* stored, int words, const KmerCode& code) {
+    for (int j = words - 1; j >= 0; j--) {
+        if (stored[j] != code.w[j]) return stored[j] < code.w[j] ? -1 : 1;
+    }
+    return 0;
+}
+
+inline bool bitmapContains(const uint64_t* bitmap, uint64_t code) {
+    return (bitmap[code >> 6] >> (code & 63)) & 1;
+}
+
+// Множество упакованных k-меров: открытая адресация с линейным пробированием.
+// Ячейка занимает ровно kmerWords(k) слов (8 байт для k <= 12). Младшее слово кода
+// содержит последние буквы и не бывает нулевым (буквы кодируются с 1), поэтому
+// нулевое младшее слово обозначает пустую ячейку.
+struct KmerHashSet {
+    int words;
+    vector<uint64_t> slots;
+    size_t mask;
+    size_t size;
+    
+    KmerHashSet(int codeWords = 1, size_t initialCapacity = 1024) : words(codeWords), size(0) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity) capacity *= 2;
+        slots.assign(capacity * words, 0);
+        mask = capacity - 1;
+    }
+    
+    size_t capacity() const {
+        return mask + 1;
+    }
+    
+    // Ячейка кода: найденная или первая пустая на пути проб
+    size_t findSlot(const uint64_t* data, const KmerCode& code) const {
+        size_t index = mixKmer(code) & mask;
+        if (words == 1) {
+            while (data[index] != 0 && data[index] != code.w[0]) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+        while (data[index * words] != 0 && compareKmer(&data[index * words], words, code) != 0) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+    
+    void insert(const KmerCode& code) {
+        if ((size + 1) * 2 > capacity()) {
+            grow();
+        }
+        size_t index = findSlot(slots.data(), code);
+        if (slots[index * words] != 0) return;
+        for (int j = 0; j < words; j++) {
+            slots[index * words + j] = code.w[j];
+        }
+        size++;
+    }
+    
+    bool contains(const KmerCode& code) const {
+        return slots[findSlot(slots.data(), code) * words] != 0;
+    }
+    
+    void grow() {
+        vector<uint64_t> old;
+        old.swap(slots);
+        size_t oldCapacity = capacity();
+        slots.assign(oldCapacity * 2 * words, 0);
+        mask = oldCapacity * 2 - 1;
+        KmerCode code = {{0, 0, 0}};
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (old[i * words] == 0) continue;
+            for (int j = 0; j < words; j++) {
+                code.w[j] = old[i * words + j];
+            }
+            size_t index = findSlot(slots.data(), code);
+            for (int j = 0; j < words; j++) {
+                slots[index * words + j] = code.w[j];
+            }
+        }
+    }
+};
+
+// Больше этого хеш-множество заранее не резервируется, дальше растет по мере вставки
+const size_t KMER_SET_MAX_PRESIZE = 1 << 22;
+
+// Битовая таблица выбирается для малых k, если она не больше хеш-множества
+// на ожидаемое число k-меров (иначе тысячи коротких геномов съедят память)
+inline bool useDirectKmerSet(int k, size_t expectedKmers) {
+    if (k > DIRECT_MAX_K) return false;
+    size_t bitmapBytes = (1ULL << (5 * k)) / 8;
+    return bitmapBytes <= 4096 || bitmapBytes <= expectedKmers * 2 * kmerWords(k) * sizeof(uint64_t);
+}
+
+// Множество k-меров генома: битовая таблица для малых k, хеш-множество для больших
+struct KmerSet {
+    int k;
+    bool direct;
+    vector<uint64_t> bitmap;
+    KmerHashSet hashed;
+    
+    KmerSet(int kmerLength, size_t expectedKmers = 1024)
+        : k(kmerLength), direct(useDirectKmerSet(kmerLength, expectedKmers)),
+          hashed(kmerWords(kmerLength), useDirectKmerSet(kmerLength, expectedKmers) ? 16
+                 : min(expectedKmers, KMER_SET_MAX_PRESIZE) * 2) {
+        if (direct) {
+            bitmap.assign(((1ULL << (5 * k)) + 63) / 64, 0);
+        }
+    }
+    
+    void insert(const KmerCode& code) {
+        if (direct) {
+            bitmap[code.w[0] >> 6] |= 1ULL << (code.w[0] & 63);
+        } else {
+            hashed.insert(code);
+        }
+    }
+    
+    bool contains(const KmerCode& code) const {
+        if (direct) {
+            return bitmapContains(bitmap.data(), code.w[0]);
+        }
+        return hashed.contains(code);
+    }
+    
+    // Добавляет все k-меры фрагмента генома, продолжая окно roller
+    void addSequence(KmerRoller& roller, const char* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            if (roller.push(data[i])) {
+                insert(roller.code);
+            }
+        }
+    }
+    
+    // Считает k-меры фрагмента, присутствующие в множестве
+    long long countPresent(KmerRoller& roller, const char* data, size_t length) const {
+        long long count = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (roller.push(data[i])) {
+                count += contains(roller.code);
+            }
+        }
+        return count;
     }
 };
 
@@ -36,44 +472,865 @@ bool isValidGenome(const string& genome) {
         return false;
     }
     
-    for (char c : genome) {
-        if (!isupper(c) || c < 'A' || c > 'Z') {
-            cout << "Ошибка: геном должен содержать только заглавные латинские буквы (A-Z)" << endl;
-            cout << "Найден недопустимый символ: '" << c << "'" << endl;
-            return false;
-        }
+    size_t invalid = genomeKernels().findInvalidChar(genome.data(), genome.length());
+    if (invalid != genome.length()) {
+        cout << "Ошибка: геном должен содержать только заглавные латинские буквы (A-Z)" << endl;
+        cout << "Найден недопустимый символ: '" << genome[invalid] << "'" << endl;
+        return false;
     }
     
     return true;
 }
 
 // Функция для вычисления степени близости
-int calculateSimilarity(const string& genome1, const string& genome2) {
+int64_t calculateSimilarity(const string& genome1, const string& genome2) {
     if (genome1.length() < 2 || genome2.length() < 2) {
         return 0;
     }
 
-    // Создаем множество всех пар второго генома
+    // Создаем множество всех пар второго генома (без выделения подстрок)
+    const GenomeKernels& kernels = genomeKernels();
     PairSet pairs_genome2;
-    for (size_t i = 0; i + 1 < genome2.length(); i++) {
-        string pair = genome2.substr(i, 2);
-        pairs_genome2.insert(pair);
-    }
+    kernels.insertPairs(pairs_genome2, genome2.data(), genome2.length());
 
     // Подсчитываем совпадающие пары первого генома
-    int similarity = 0;
+    return kernels.countPairs(pairs_genome2, genome1.data(), genome1.length());
+}
+
+// Степень близости по k-мерам: сколько k-меров первого генома встречается во втором
+int64_t calculateKmerSimilarity(const string& genome1, const string& genome2, int k) {
+    if (k == 2) {
+        return calculateSimilarity(genome1, genome2);
+    }
+    if (genome1.length() < static_cast<size_t>(k) || genome2.length() < static_cast<size_t>(k)) {
+        return 0;
+    }
+
+    KmerSet kmers_genome2(k, genome2.length() - k + 1);
+    KmerRoller roller(k);
+    kmers_genome2.addSequence(roller, genome2.data(), genome2.length());
+
+    roller.reset();
+    return kmers_genome2.countPresent(roller, genome1.data(), genome1.length());
+}
+
+// Запись многозаписного файла: имя и геном
+struct GenomeRecord {
+    string name;
+    string genome;
+};
+
+// Читает файл в формате FASTA (">имя" и строки генома).
+// Если заголовков нет, каждая непустая строка считается отдельным геномом.
+bool readGenomeRecords(const string& filename, vector<GenomeRecord>& records) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+        return false;
+    }
+    
+    string line;
+    bool hasHeaders = false;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        
+        if (line[0] == '>') {
+            hasHeaders = true;
+            records.push_back(GenomeRecord{line.substr(1), ""});
+        } else if (hasHeaders) {
+            records.back().genome += line;
+        } else {
+            records.push_back(GenomeRecord{"genome" + to_string(records.size() + 1), line});
+        }
+    }
+    
+    for (const GenomeRecord& record : records) {
+        if (!isValidGenome(record.genome)) {
+            cerr << "Ошибка: некорректный геном в записи '" << record.name << "'" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Профиль генома для пакетного режима: различные k-меры с кратностями
+// и множество для проверки принадлежности. Строится один раз на геном.
+struct GenomeProfile {
+    vector<KmerCode> codes;
+    vector<uint32_t> counts;
+    KmerSet set;
+    
+    GenomeProfile(int k) : set(k, 16) {}
+    
+    void build(const string& genome, int k) {
+        if (genome.length() < static_cast<size_t>(k)) return;
+        
+        vector<KmerCode> all;
+        all.reserve(genome.length() - k + 1);
+        KmerRoller roller(k);
+        for (char c : genome) {
+            if (roller.push(c)) {
+                all.push_back(roller.code);
+            }
+        }
+        sort(all.begin(), all.end());
+        
+        for (size_t i = 0; i < all.size(); ) {
+            size_t j = i;
+            while (j < all.size() && all[j] == all[i]) j++;
+            codes.push_back(all[i]);
+            counts.push_back(static_cast<uint32_t>(j - i));
+            i = j;
+        }
+        
+        set = KmerSet(k, codes.size());
+        for (const KmerCode& code : codes) {
+            set.insert(code);
+        }
+    }
+    
+    // Сколько k-меров этого генома (с учетом повторов) есть в другом геноме
+    long long similarityTo(const GenomeProfile& other) const {
+        long long similarity = 0;
+        for (size_t i = 0; i < codes.size(); i++) {
+            if (other.set.contains(codes[i])) {
+                similarity += counts[i];
+            }
+        }
+        return similarity;
+    }
+};
+
+// Пиковое потребление памяти процессом в мегабайтах
+double peakMemoryMB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// Запускает func(index) для index из [0, count) на threadCount потоках
+template <typename Func>
+void parallelFor(size_t count, int threadCount, Func func) {
+    atomic<size_t> next(0);
+    vector<thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            size_t index;
+            while ((index = next.fetch_add(1)) < count) {
+                func(index);
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+bool saveMatrixCsv(const string& filename, const vector<GenomeRecord>& records,
+                   const vector<long long>& matrix) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для записи" << endl;
+        return false;
+    }
+    
+    size_t n = records.size();
+    file << "genome";
+    for (const GenomeRecord& record : records) {
+        file << ',' << record.name;
+    }
+    file << '\n';
+    for (size_t i = 0; i < n; i++) {
+        file << records[i].name;
+        for (size_t j = 0; j < n; j++) {
+            file << ',' << matrix[i * n + j];
+        }
+        file << '\n';
+    }
+    return file.good();
+}
+
+// Двоичный формат: "GSIM", uint32 N, uint32 k, N имен (uint32 длина + байты),
+// затем N*N значений int64 по строкам
+bool saveMatrixBinary(const string& filename, const vector<GenomeRecord>& records,
+                      const vector<long long>& matrix, int k) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для записи" << endl;
+        return false;
+    }
+    
+    uint32_t n = static_cast<uint32_t>(records.size());
+    uint32_t kmerLength = static_cast<uint32_t>(k);
+    file.write("GSIM", 4);
+    file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    file.write(reinterpret_cast<const char*>(&kmerLength), sizeof(kmerLength));
+    for (const GenomeRecord& record : records) {
+        uint32_t length = static_cast<uint32_t>(record.name.length());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(record.name.data(), length);
+    }
+    file.write(reinterpret_cast<const char*>(matrix.data()), matrix.size() * sizeof(long long));
+    return file.good();
+}
+
+// Размер стороны плитки матрицы, обрабатываемой одним потоком
+const size_t MATRIX_TILE = 64;
+
+// Пакетный режим: матрица близости N x N для всех геномов файла.
+// Элемент [i][j] - сколько k-меров генома i встречается в геноме j.
+int runBatchMode(const string& inputFile, const string& outputFile, const string& format,
+                 int k, int threadCount) {
+    auto start = chrono::steady_clock::now();
+    
+    vector<GenomeRecord> records;
+    if (!readGenomeRecords(inputFile, records)) {
+        return 1;
+    }
+    if (records.empty()) {
+        cerr << "Ошибка: в файле " << inputFile << " нет геномов" << endl;
+        return 1;
+    }
+    size_t n = records.size();
+    cout << "Загружено геномов: " << n << endl;
+    
+    // Профили строятся один раз на геном, после чего исходные строки не нужны
+    vector<GenomeProfile> profiles(n, GenomeProfile(k));
+    parallelFor(n, threadCount, [&](size_t i) {
+        profiles[i].build(records[i].genome, k);
+        string().swap(records[i].genome);
+    });
+    auto built = chrono::steady_clock::now();
+    
+    vector<long long> matrix(n * n, 0);
+    size_t tilesPerSide = (n + MATRIX_TILE - 1) / MATRIX_TILE;
+    parallelFor(tilesPerSide * tilesPerSide, threadCount, [&](size_t tile) {
+        size_t rowBegin = (tile / tilesPerSide) * MATRIX_TILE;
+        size_t colBegin = (tile % tilesPerSide) * MATRIX_TILE;
+        size_t rowEnd = min(rowBegin + MATRIX_TILE, n);
+        size_t colEnd = min(colBegin + MATRIX_TILE, n);
+        for (size_t i = rowBegin; i < rowEnd; i++) {
+            for (size_t j = colBegin; j < colEnd; j++) {
+                matrix[i * n + j] = profiles[i].similarityTo(profiles[j]);
+            }
+        }
+    });
+    auto computed = chrono::steady_clock::now();
+    
+    bool saved = format == "bin"
+        ? saveMatrixBinary(outputFile, records, matrix, k)
+        : saveMatrixCsv(outputFile, records, matrix);
+    if (!saved) {
+        cerr << "Ошибка при записи матрицы в файл " << outputFile << endl;
+        return 1;
+    }
+    
+    double buildSeconds = chrono::duration<double>(built - start).count();
+    double matrixSeconds = chrono::duration<double>(computed - built).count();
+    double pairs = static_cast<double>(n) * n;
+    cout << "Матрица " << n << "x" << n << " записана в " << outputFile << endl;
+    cout << "Потоков: " << threadCount << endl;
+    cout << "Чтение и построение множеств: " << buildSeconds << " с" << endl;
+    cout << "Вычисление матрицы: " << matrixSeconds << " с ("
+         << (matrixSeconds > 0 ? pairs / matrixSeconds : pairs) << " пар/с)" << endl;
+    cout << "Пиковая память: " << peakMemoryMB() << " МБ" << endl;
+    return 0;
+}
+
+// Размер фрагмента потокового чтения по умолчанию (байт)
+const size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+// Файл генома, читаемый фрагментами фиксированного размера
+struct GenomeStream {
+    string filename;
+    ifstream file;
+    vector<char> buffer;
+    size_t fileSize;
+    
+    GenomeStream(const string& name, size_t chunkSize)
+        : filename(name), file(name, ios::binary), buffer(chunkSize), fileSize(0) {
+        if (file.is_open()) {
+            file.seekg(0, ios::end);
+            fileSize = static_cast<size_t>(file.tellg());
+            file.seekg(0, ios::beg);
+        }
+    }
+    
+    bool isOpen() const {
+        return file.is_open();
+    }
+    
+    // Читает следующий фрагмент в buffer; возвращает число байт, 0 в конце файла
+    size_t next() {
+        file.read(buffer.data(), buffer.size());
+        return static_cast<size_t>(file.gcount());
+    }
+};
+
+// Проходит по файлу генома один раз: проверяет символы (как isValidGenome) и
+// передает каждый полный k-мер в onKmer. Перекрытие в k-1 символ между фрагментами
+// хранится в состоянии roller, поэтому фрагменты не склеиваются и не копируются.
+// Переводы строк пропускаются. Возвращает false при некорректном геноме.
+template <typename OnKmer>
+bool streamGenomeKmers(GenomeStream& stream, KmerRoller& roller, size_t& letters, OnKmer onKmer) {
+    letters = 0;
+    size_t offset = 0;
+    size_t length;
+    while ((length = stream.next()) > 0) {
+        const char* data = stream.buffer.data();
+        for (size_t i = 0; i < length; i++) {
+            char c = data[i];
+            if (static_cast<unsigned char>(c - 'A') < 26) {
+                letters++;
+                if (roller.push(c)) {
+                    onKmer(roller.code);
+                }
+            } else if (c != '\n' && c != '\r') {
+                cout << "Ошибка: геном должен содержать только заглавные латинские буквы (A-Z)" << endl;
+                cout << "Найден недопустимый символ: '" << c << "' в файле " << stream.filename
+                     << " (позиция " << offset + i << ")" << endl;
+                return false;
+            }
+        }
+        offset += length;
+    }
+    if (letters == 0) {
+        cout << "Ошибка: геном не может быть пустой строкой (файл " << stream.filename << ")" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Потоковый режим: геномы читаются из файлов фрагментами, в памяти хранится
+// только множество k-меров второго генома и один буфер на файл
+int runStreamMode(const string& file1, const string& file2, int k, size_t chunkSize) {
+    auto start = chrono::steady_clock::now();
+    
+    GenomeStream stream2(file2, chunkSize);
+    if (!stream2.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << file2 << " для чтения" << endl;
+        return 1;
+    }
+    GenomeStream stream1(file1, chunkSize);
+    if (!stream1.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << file1 << " для чтения" << endl;
+        return 1;
+    }
+    
+    KmerSet kmers_genome2(k, stream2.fileSize);
+    KmerRoller roller(k);
+    size_t letters2 = 0;
+    if (!streamGenomeKmers(stream2, roller, letters2,
+                           [&](const KmerCode& code) { kmers_genome2.insert(code); })) {
+        return 1;
+    }
+    
+    roller.reset();
+    size_t letters1 = 0;
+    long long similarity = 0;
+    if (!streamGenomeKmers(stream1, roller, letters1,
+                           [&](const KmerCode& code) { similarity += kmers_genome2.contains(code); })) {
+        return 1;
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double megabytes = (stream1.fileSize + stream2.fileSize) / (1024.0 * 1024.0);
+    cout << "Степень близости: " << similarity << endl;
+    cout << "Обработано символов: " << letters1 << " + " << letters2 << " за " << seconds << " с ("
+         << (seconds > 0 ? megabytes / seconds : megabytes) << " МБ/с)" << endl;
+    cout << "Пиковая память: " << peakMemoryMB() << " МБ" << endl;
+    return 0;
+}
+
+// Заголовок файла индекса k-меров; данные идут сразу за ним и выровнены по 8 байт.
+// kind 0 - битовая таблица (entries слов uint64), kind 2 - различные k-меры по
+// возрастанию, плотно: entries кодов по kmerWords(k) слов (kind 1, ячейки
+// хеш-множества, больше не записывается).
+struct KmerIndexHeader {
+    char magic[4];
+    uint32_t k;
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t entries;
+    uint64_t distinct;
+};
+
+const uint32_t KMER_INDEX_BITMAP = 0;
+const uint32_t KMER_INDEX_SORTED = 2;
+
+// Различные коды хеш-множества по возрастанию, по W слов на код
+template <int W>
+vector<array<uint64_t, W>> sortedKmerCodes(KmerHashSet& hashed) {
+    vector<array<uint64_t, W>> codes;
+    codes.reserve(hashed.size);
+    for (size_t i = 0; i < hashed.capacity(); i++) {
+        if (hashed.slots[i * W] == 0) continue;
+        array<uint64_t, W> code;
+        for (int j = 0; j < W; j++) {
+            code[j] = hashed.slots[i * W + j];
+        }
+        codes.push_back(code);
+    }
+    // Ячейки больше не нужны: освобождаем их до сортировки
+    vector<uint64_t>().swap(hashed.slots);
+    sort(codes.begin(), codes.end(), [](const array<uint64_t, W>& a, const array<uint64_t, W>& b) {
+        for (int j = W - 1; j >= 0; j--) {
+            if (a[j] != b[j]) return a[j] < b[j];
+        }
+        return false;
+    });
+    return codes;
+}
+
+// Запись упорядоченных кодов после заголовка
+template <int W>
+bool writeSortedKmerCodes(ofstream& file, KmerHashSet& hashed) {
+    vector<array<uint64_t, W>> codes = sortedKmerCodes<W>(hashed);
+    file.write(reinterpret_cast<const char*>(codes.data()), codes.size() * sizeof(codes[0]));
+    return file.good();
+}
+
+// Построение индекса k-меров эталонного генома (файл читается потоково)
+int runBuildIndexMode(const string& referenceFile, const string& indexFile, int k, size_t chunkSize) {
+    auto start = chrono::steady_clock::now();
     
-    for (size_t i = 0; i + 1 < genome1.length(); i++) {
-        string pair = genome1.substr(i, 2);
-        if (pairs_genome2.contains(pair)) {
-            similarity++;
+    GenomeStream stream(referenceFile, chunkSize);
+    if (!stream.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << referenceFile << " для чтения" << endl;
+        return 1;
+    }
+    
+    KmerSet kmers(k, stream.fileSize);
+    KmerRoller roller(k);
+    size_t letters = 0;
+    size_t distinct = 0;
+    if (!streamGenomeKmers(stream, roller, letters, [&](const KmerCode& code) { kmers.insert(code); })) {
+        return 1;
+    }
+    
+    KmerIndexHeader header = {{'G', 'K', 'M', 'I'}, static_cast<uint32_t>(k), 0, 0, 0, 0};
+    if (kmers.direct) {
+        header.kind = KMER_INDEX_BITMAP;
+        header.entries = kmers.bitmap.size();
+        for (uint64_t word : kmers.bitmap) {
+            distinct += __builtin_popcountll(word);
         }
+    } else {
+        header.kind = KMER_INDEX_SORTED;
+        distinct = kmers.hashed.size;
+        header.entries = distinct;
+    }
+    header.distinct = distinct;
+    
+    ofstream file(indexFile, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << indexFile << " для записи" << endl;
+        return 1;
     }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (kmers.direct) {
+        file.write(reinterpret_cast<const char*>(kmers.bitmap.data()), kmers.bitmap.size() * sizeof(uint64_t));
+    } else if (kmerWords(k) == 1) {
+        writeSortedKmerCodes<1>(file, kmers.hashed);
+    } else if (kmerWords(k) == 2) {
+        writeSortedKmerCodes<2>(file, kmers.hashed);
+    } else {
+        writeSortedKmerCodes<3>(file, kmers.hashed);
+    }
+    if (!file.good()) {
+        cerr << "Ошибка при записи индекса в файл " << indexFile << endl;
+        return 1;
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Индекс k-меров (k=" << k << ", " << (kmers.direct ? "битовая таблица" : "упорядоченный массив")
+         << ", различных k-меров: " << distinct << ") записан в " << indexFile
+         << " за " << seconds << " с" << endl;
+    return 0;
+}
 
-    return similarity;
+// Индекс k-меров, отображенный в память: данные не копируются и не перестраиваются,
+// страницы подгружаются по мере обращения
+struct MappedKmerIndex {
+    void* mapping;
+    size_t mappingSize;
+    const KmerIndexHeader* header;
+    const uint64_t* bitmap;
+    const uint64_t* codes;   // Упорядоченные коды по words слов
+    int words;
+    size_t count;
+    
+    MappedKmerIndex() : mapping(MAP_FAILED), mappingSize(0), header(nullptr),
+                        bitmap(nullptr), codes(nullptr), words(1), count(0) {}
+    
+    ~MappedKmerIndex() {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mappingSize);
+        }
+    }
+    
+    bool open(const string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(KmerIndexHeader)) {
+            cerr << "Ошибка: файл " << filename << " не является индексом k-меров" << endl;
+            close(fd);
+            return false;
+        }
+        mappingSize = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            cerr << "Ошибка: не удалось отобразить файл " << filename << " в память" << endl;
+            return false;
+        }
+        
+        header = static_cast<const KmerIndexHeader*>(mapping);
+        const char* payload = static_cast<const char*>(mapping) + sizeof(KmerIndexHeader);
+        size_t payloadBytes = mappingSize - sizeof(KmerIndexHeader);
+        bool valid = string(header->magic, 4) == "GKMI" && header->k >= MIN_K && header->k <= MAX_K;
+        if (valid && header->kind == KMER_INDEX_BITMAP) {
+            valid = header->k <= DIRECT_MAX_K &&
+                    header->entries == ((1ULL << (5 * header->k)) + 63) / 64 &&
+                    payloadBytes == header->entries * sizeof(uint64_t);
+            bitmap = reinterpret_cast<const uint64_t*>(payload);
+        } else if (valid && header->kind == KMER_INDEX_SORTED) {
+            words = kmerWords(static_cast<int>(header->k));
+            valid = header->entries == header->distinct &&
+                    header->entries <= payloadBytes / (words * sizeof(uint64_t)) &&
+                    payloadBytes == header->entries * words * sizeof(uint64_t);
+            codes = reinterpret_cast<const uint64_t*>(payload);
+            count = header->entries;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            cerr << "Ошибка: файл " << filename << " не является индексом k-меров или поврежден" << endl;
+        }
+        return valid;
+    }
+    
+    int k() const {
+        return static_cast<int>(header->k);
+    }
+    
+    // Для упорядоченного массива - двоичный поиск
+    bool contains(const KmerCode& code) const {
+        if (bitmap) {
+            return bitmapContains(bitmap, code.w[0]);
+        }
+        if (words == 1) {
+            return binary_search(codes, codes + count, code.w[0]);
+        }
+        size_t low = 0, high = count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            int order = compareKmer(codes + middle * words, words, code);
+            if (order == 0) return true;
+            if (order < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return false;
+    }
+};
+
+// Запрос к сохраненному индексу: индекс отображается в память, потоково читается только запрос
+int runIndexQueryMode(const string& queryFile, const string& indexFile, size_t chunkSize) {
+    auto start = chrono::steady_clock::now();
+    
+    MappedKmerIndex index;
+    if (!index.open(indexFile)) {
+        return 1;
+    }
+    auto mapped = chrono::steady_clock::now();
+    
+    GenomeStream stream(queryFile, chunkSize);
+    if (!stream.isOpen()) {
+        cerr << "Ошибка: Не удалось открыть файл " << queryFile << " для чтения" << endl;
+        return 1;
+    }
+    
+    KmerRoller roller(index.k());
+    size_t letters = 0;
+    long long similarity = 0;
+    if (!streamGenomeKmers(stream, roller, letters,
+                           [&](const KmerCode& code) { similarity += index.contains(code); })) {
+        return 1;
+    }
+    
+    auto finished = chrono::steady_clock::now();
+    cout << "Степень близости: " << similarity << endl;
+    cout << "Открытие индекса: " << chrono::duration<double, milli>(mapped - start).count() << " мс, "
+         << "обработка запроса: " << chrono::duration<double>(finished - mapped).count() << " с" << endl;
+    return 0;
 }
 
-int main() {
+// Размер MinHash-эскиза по умолчанию (число наименьших хешей k-меров)
+const int DEFAULT_SKETCH_SIZE = 1000;
+
+// Эскиз bottom-s: s наименьших различных хешей k-меров генома, по возрастанию
+struct MinHashSketch {
+    string name;
+    vector<uint64_t> hashes;
+    
+    void build(const string& genome, int k, size_t sketchSize) {
+        set<uint64_t> smallest;
+        KmerRoller roller(k);
+        for (char c : genome) {
+            if (!roller.push(c)) continue;
+            uint64_t h = mixKmer(roller.code);
+            if (smallest.size() < sketchSize) {
+                smallest.insert(h);
+            } else if (h < *smallest.rbegin() && smallest.insert(h).second) {
+                smallest.erase(prev(smallest.end()));
+            }
+        }
+        hashes.assign(smallest.begin(), smallest.end());
+    }
+};
+
+// Оценка индекса Жаккара по эскизам: доля общих хешей среди s наименьших хешей объединения
+double estimateJaccard(const MinHashSketch& a, const MinHashSketch& b, size_t sketchSize) {
+    size_t i = 0, j = 0, taken = 0, shared = 0;
+    while (taken < sketchSize && i < a.hashes.size() && j < b.hashes.size()) {
+        if (a.hashes[i] == b.hashes[j]) {
+            shared++;
+            i++;
+            j++;
+        } else if (a.hashes[i] < b.hashes[j]) {
+            i++;
+        } else {
+            j++;
+        }
+        taken++;
+    }
+    taken += min(sketchSize - taken, (a.hashes.size() - i) + (b.hashes.size() - j));
+    return taken == 0 ? 0.0 : static_cast<double>(shared) / taken;
+}
+
+// Индекс эскизов: "GSKH", uint32 k, uint32 размер эскиза, uint32 число геномов,
+// затем для каждого генома uint32 длина имени, имя, uint32 число хешей, хеши uint64
+bool saveSketchIndex(const string& filename, const vector<MinHashSketch>& sketches,
+                     int k, size_t sketchSize) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для записи" << endl;
+        return false;
+    }
+    
+    uint32_t header[3] = {static_cast<uint32_t>(k), static_cast<uint32_t>(sketchSize),
+                          static_cast<uint32_t>(sketches.size())};
+    file.write("GSKH", 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const MinHashSketch& sketch : sketches) {
+        uint32_t nameLength = static_cast<uint32_t>(sketch.name.length());
+        uint32_t hashCount = static_cast<uint32_t>(sketch.hashes.size());
+        file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+        file.write(sketch.name.data(), nameLength);
+        file.write(reinterpret_cast<const char*>(&hashCount), sizeof(hashCount));
+        file.write(reinterpret_cast<const char*>(sketch.hashes.data()), hashCount * sizeof(uint64_t));
+    }
+    return file.good();
+}
+
+bool loadSketchIndex(const string& filename, vector<MinHashSketch>& sketches,
+                     int& k, size_t& sketchSize) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+        return false;
+    }
+    
+    char magic[4];
+    uint32_t header[3];
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || string(magic, 4) != "GSKH" || header[0] < MIN_K || header[0] > MAX_K) {
+        cerr << "Ошибка: файл " << filename << " не является индексом эскизов" << endl;
+        return false;
+    }
+    k = static_cast<int>(header[0]);
+    sketchSize = header[1];
+    
+    sketches.resize(header[2]);
+    for (MinHashSketch& sketch : sketches) {
+        uint32_t nameLength = 0, hashCount = 0;
+        file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+        sketch.name.resize(nameLength);
+        file.read(&sketch.name[0], nameLength);
+        file.read(reinterpret_cast<char*>(&hashCount), sizeof(hashCount));
+        if (!file || hashCount > sketchSize) {
+            cerr << "Ошибка: индекс эскизов " << filename << " поврежден" << endl;
+            return false;
+        }
+        sketch.hashes.resize(hashCount);
+        file.read(reinterpret_cast<char*>(sketch.hashes.data()), hashCount * sizeof(uint64_t));
+    }
+    if (!file) {
+        cerr << "Ошибка: индекс эскизов " << filename << " поврежден" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Построение индекса эскизов для всех геномов файла
+int runSketchMode(const string& referenceFile, const string& indexFile, int k,
+                  size_t sketchSize, int threadCount) {
+    auto start = chrono::steady_clock::now();
+    
+    vector<GenomeRecord> records;
+    if (!readGenomeRecords(referenceFile, records)) {
+        return 1;
+    }
+    
+    vector<MinHashSketch> sketches(records.size());
+    parallelFor(records.size(), threadCount, [&](size_t i) {
+        sketches[i].name = records[i].name;
+        sketches[i].build(records[i].genome, k, sketchSize);
+    });
+    
+    if (!saveSketchIndex(indexFile, sketches, k, sketchSize)) {
+        cerr << "Ошибка при записи индекса в файл " << indexFile << endl;
+        return 1;
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Индекс эскизов для " << sketches.size() << " геномов записан в " << indexFile
+         << " за " << seconds << " с" << endl;
+    return 0;
+}
+
+// Поиск top-N ближайших геномов индекса для каждого генома из queryFile.
+// Если указан rerankFile (исходные геномы индекса), кандидаты пересортировываются
+// по точной степени близости calculateKmerSimilarity.
+int runQueryMode(const string& queryFile, const string& indexFile, const string& rerankFile,
+                 int topN) {
+    vector<MinHashSketch> sketches;
+    int k = 0;
+    size_t sketchSize = 0;
+    if (!loadSketchIndex(indexFile, sketches, k, sketchSize)) {
+        return 1;
+    }
+    
+    vector<GenomeRecord> queries;
+    if (!readGenomeRecords(queryFile, queries)) {
+        return 1;
+    }
+    
+    vector<GenomeRecord> references;
+    if (!rerankFile.empty()) {
+        if (!readGenomeRecords(rerankFile, references)) {
+            return 1;
+        }
+        if (references.size() != sketches.size()) {
+            cerr << "Ошибка: в " << rerankFile << " " << references.size() << " геномов, а в индексе "
+                 << sketches.size() << endl;
+            return 1;
+        }
+    }
+    
+    size_t resultCount = min(static_cast<size_t>(topN), sketches.size());
+    for (const GenomeRecord& query : queries) {
+        MinHashSketch querySketch;
+        querySketch.build(query.genome, k, sketchSize);
+        
+        vector<pair<double, size_t>> ranked(sketches.size());
+        for (size_t i = 0; i < sketches.size(); i++) {
+            ranked[i] = make_pair(estimateJaccard(querySketch, sketches[i], sketchSize), i);
+        }
+        partial_sort(ranked.begin(), ranked.begin() + resultCount, ranked.end(),
+                     [](const pair<double, size_t>& a, const pair<double, size_t>& b) {
+                         return a.first > b.first;
+                     });
+        ranked.resize(resultCount);
+        
+        vector<long long> exact(resultCount, 0);
+        if (!references.empty()) {
+            vector<size_t> order(resultCount);
+            for (size_t r = 0; r < resultCount; r++) {
+                order[r] = r;
+                exact[r] = calculateKmerSimilarity(query.genome, references[ranked[r].second].genome, k);
+            }
+            stable_sort(order.begin(), order.end(),
+                        [&](size_t a, size_t b) { return exact[a] > exact[b]; });
+            vector<pair<double, size_t>> reranked;
+            vector<long long> reorderedExact;
+            for (size_t r : order) {
+                reranked.push_back(ranked[r]);
+                reorderedExact.push_back(exact[r]);
+            }
+            ranked.swap(reranked);
+            exact.swap(reorderedExact);
+        }
+        
+        cout << "Запрос " << query.name << ":" << endl;
+        for (size_t r = 0; r < resultCount; r++) {
+            cout << "  " << r + 1 << ". " << sketches[ranked[r].second].name
+                 << " (оценка Жаккара: " << ranked[r].first;
+            if (!references.empty()) {
+                cout << ", степень близости: " << exact[r];
+            }
+            cout << ")" << endl;
+        }
+    }
+    return 0;
+}
+
+// Микробенчмарк ядер: проверка и подсчет пар на случайных геномах размером megabytes МБ
+int runKernelBenchmark(int megabytes) {
+    size_t length = static_cast<size_t>(megabytes) * 1024 * 1024;
+    string genome1(length, 'A'), genome2(length, 'A');
+    mt19937 generator(42);
+    // Ограниченный алфавит, чтобы в таблице были и совпадающие, и отсутствующие пары
+    uniform_int_distribution<int> letter(0, 19);
+    for (size_t i = 0; i < length; i++) {
+        genome1[i] = static_cast<char>('A' + letter(generator));
+        genome2[i] = static_cast<char>('A' + (letter(generator) + 6) % 26);
+    }
+    string invalid = genome1;
+    invalid[length - 3] = 'a';
+    
+    cout << "Бенчмарк ядер на геномах по " << megabytes << " МБ" << endl;
+    long long expected = -1;
+    for (const GenomeKernels& kernels : availableGenomeKernels()) {
+        auto start = chrono::steady_clock::now();
+        size_t validEnd = kernels.findInvalidChar(genome1.data(), length);
+        size_t invalidAt = kernels.findInvalidChar(invalid.data(), length);
+        auto validated = chrono::steady_clock::now();
+        
+        PairSet pairs;
+        kernels.insertPairs(pairs, genome2.data(), length);
+        auto inserted = chrono::steady_clock::now();
+        
+        long long similarity = kernels.countPairs(pairs, genome1.data(), length);
+        auto counted = chrono::steady_clock::now();
+        
+        double validateSeconds = chrono::duration<double>(validated - start).count() / 2;
+        double insertSeconds = chrono::duration<double>(inserted - validated).count();
+        double countSeconds = chrono::duration<double>(counted - inserted).count();
+        bool correct = validEnd == length && invalidAt == length - 3 &&
+                       (expected < 0 || similarity == expected);
+        if (expected < 0) expected = similarity;
+        
+        cout << "  " << kernels.name << ": проверка " << megabytes / validateSeconds << " МБ/с, "
+             << "построение пар " << megabytes / insertSeconds << " МБ/с, "
+             << "подсчет пар " << megabytes / countSeconds << " МБ/с, "
+             << "степень близости " << similarity << (correct ? "" : " (РАСХОЖДЕНИЕ!)") << endl;
+        if (!correct) return 1;
+    }
+    return 0;
+}
+
+// Интерактивный режим: два генома с клавиатуры
+int runInteractiveMode(int k) {
     cout << "Степень близости геномов" << endl;
     
     string genome1, genome2;
@@ -107,8 +1364,182 @@ int main() {
     }
     
     // Вычисление и вывод результата
-    int similarity = calculateSimilarity(genome1, genome2);
+    int64_t similarity = calculateKmerSimilarity(genome1, genome2, k);
     cout << "Степень близости: " << similarity << endl;
     
     return 0;
+}
+
+void printUsage(const string& programName) {
+    cout << "Использование: " << programName << " [--k <длина k-мера>]" << endl;
+    cout << "       " << programName << " --batch <файл геномов> --out <файл матрицы>"
+         << " [--format csv|bin] [--threads <число>] [--k <длина k-мера>]" << endl;
+    cout << "       " << programName << " --genome1 <файл> --genome2 <файл>"
+         << " [--chunk <байт>] [--k <длина k-мера>]" << endl;
+    cout << "       " << programName << " --sketch <файл геномов> --index <файл индекса>"
+         << " [--sketch-size <число>] [--k <длина k-мера>]" << endl;
+    cout << "       " << programName << " --query <файл геномов> --index <файл индекса>"
+         << " [--top <число>] [--rerank <файл геномов индекса>]" << endl;
+    cout << "       " << programName << " --build-index <файл эталона> --kmer-index <файл индекса>"
+         << " [--k <длина k-мера>]" << endl;
+    cout << "       " << programName << " --genome1 <файл запроса> --kmer-index <файл индекса>" << endl;
+    cout << "       " << programName << " --bench <мегабайт>" << endl;
+    cout << "  --k        длина сравниваемых подстрок, от " << MIN_K << " до " << MAX_K
+         << " (по умолчанию 2)" << endl;
+    cout << "  --batch    файл FASTA (или один геном в строке) для матрицы близости всех пар" << endl;
+    cout << "  --format   формат матрицы: csv (по умолчанию) или bin" << endl;
+    cout << "  --threads  число потоков (по умолчанию - число ядер)" << endl;
+    cout << "  --genome1, --genome2  потоковое сравнение геномов из файлов любого размера" << endl;
+    cout << "  --chunk    размер фрагмента чтения (по умолчанию " << DEFAULT_CHUNK_SIZE << ")" << endl;
+    cout << "  --bench    сравнить векторные и скалярное ядра пар (ядро выбирается автоматически)" << endl;
+    cout << "  --sketch   построить индекс MinHash-эскизов (по умолчанию " << DEFAULT_SKETCH_SIZE
+         << " хешей на геном)" << endl;
+    cout << "  --query    найти --top (по умолчанию 10) ближайших геномов индекса;"
+         << " --rerank уточняет их точной степенью близости" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int k = 2;
+    string batchFile, outputFile, format = "csv";
+    string genomeFile1, genomeFile2;
+    size_t chunkSize = DEFAULT_CHUNK_SIZE;
+    string sketchFile, queryFile, indexFile, rerankFile;
+    string buildIndexFile, kmerIndexFile;
+    int sketchSize = DEFAULT_SKETCH_SIZE;
+    int topN = 10;
+    int benchMegabytes = 0;
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--k" || arg == "--threads" || arg == "--chunk" || arg == "--sketch-size" ||
+             arg == "--top" || arg == "--bench") && i + 1 < argc) {
+            string value = argv[++i];
+            int number;
+            try {
+                number = stoi(value);
+            } catch (const exception&) {
+                cerr << "Ошибка: " << arg << " должно быть целым числом, получено: " << value << endl;
+                return 1;
+            }
+            if (arg == "--k") {
+                k = number;
+            } else if (arg == "--chunk") {
+                if (number <= 0) {
+                    cerr << "Ошибка: размер фрагмента должен быть положительным" << endl;
+                    return 1;
+                }
+                chunkSize = static_cast<size_t>(number);
+            } else if (arg == "--sketch-size") {
+                sketchSize = number;
+            } else if (arg == "--top") {
+                topN = number;
+            } else if (arg == "--bench") {
+                if (number <= 0) {
+                    cerr << "Ошибка: размер бенчмарка должен быть положительным" << endl;
+                    return 1;
+                }
+                benchMegabytes = number;
+            } else {
+                threadCount = number;
+            }
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchFile = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--genome1" && i + 1 < argc) {
+            genomeFile1 = argv[++i];
+        } else if (arg == "--genome2" && i + 1 < argc) {
+            genomeFile2 = argv[++i];
+        } else if (arg == "--sketch" && i + 1 < argc) {
+            sketchFile = argv[++i];
+        } else if (arg == "--query" && i + 1 < argc) {
+            queryFile = argv[++i];
+        } else if (arg == "--index" && i + 1 < argc) {
+            indexFile = argv[++i];
+        } else if (arg == "--rerank" && i + 1 < argc) {
+            rerankFile = argv[++i];
+        } else if (arg == "--build-index" && i + 1 < argc) {
+            buildIndexFile = argv[++i];
+        } else if (arg == "--kmer-index" && i + 1 < argc) {
+            kmerIndexFile = argv[++i];
+        } else {
+            cerr << "Ошибка: неизвестный аргумент: " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (k < MIN_K || k > MAX_K) {
+        cerr << "Ошибка: длина k-мера должна быть от " << MIN_K << " до " << MAX_K << endl;
+        return 1;
+    }
+    if (threadCount <= 0) {
+        cerr << "Ошибка: число потоков должно быть положительным" << endl;
+        return 1;
+    }
+    if (format != "csv" && format != "bin") {
+        cerr << "Ошибка: неизвестный формат матрицы: " << format << endl;
+        return 1;
+    }
+    if (sketchSize <= 0 || topN <= 0) {
+        cerr << "Ошибка: --sketch-size и --top должны быть положительными" << endl;
+        return 1;
+    }
+    
+    if (benchMegabytes > 0) {
+        return runKernelBenchmark(benchMegabytes);
+    }
+    
+    if (!sketchFile.empty() || !queryFile.empty()) {
+        if (indexFile.empty()) {
+            cerr << "Ошибка: для эскизов нужен --index" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!sketchFile.empty()) {
+            return runSketchMode(sketchFile, indexFile, k, static_cast<size_t>(sketchSize), threadCount);
+        }
+        return runQueryMode(queryFile, indexFile, rerankFile, topN);
+    }
+    
+    if (!batchFile.empty()) {
+        if (outputFile.empty()) {
+            cerr << "Ошибка: для пакетного режима нужен --out" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runBatchMode(batchFile, outputFile, format, k, threadCount);
+    }
+    
+    if (!buildIndexFile.empty() || !kmerIndexFile.empty()) {
+        if (kmerIndexFile.empty()) {
+            cerr << "Ошибка: для индекса k-меров нужен --kmer-index" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!buildIndexFile.empty()) {
+            return runBuildIndexMode(buildIndexFile, kmerIndexFile, k, chunkSize);
+        }
+        if (genomeFile1.empty()) {
+            cerr << "Ошибка: для запроса к индексу нужен --genome1" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runIndexQueryMode(genomeFile1, kmerIndexFile, chunkSize);
+    }
+    
+    if (!genomeFile1.empty() || !genomeFile2.empty()) {
+        if (genomeFile1.empty() || genomeFile2.empty()) {
+            cerr << "Ошибка: для потокового режима нужны оба файла --genome1 и --genome2" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runStreamMode(genomeFile1, genomeFile2, k, chunkSize);
+    }
+    
+    return runInteractiveMode(k);
 }
\ No newline at end of file
@@ -2,48 +2,1012 @@
 #include <string>
 #include <sstream>
 #include <cctype>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "structures_from_lr1.h"
 
 using namespace std;
 
-struct WordDictionary {
-    SetArray* words;
+// Тексты в UTF-8: латиница и кириллица. Ударение обозначается заглавной буквой,
+// позиция ударения - смещение этой буквы в байтах (при смене регистра длина буквы
+// в UTF-8 не меняется, поэтому смещения в словаре и в тексте совпадают).
+enum LetterCase {
+    NOT_LETTER,
+    LOWER_LETTER,
+    UPPER_LETTER
+};
+
+// Декодирует символ UTF-8 в data[0..remaining); возвращает его длину в байтах,
+// при некорректной последовательности - 1 и codePoint = 0xFFFD
+size_t decodeUtf8(const unsigned char* data, size_t remaining, uint32_t& codePoint) {
+    unsigned char lead = data[0];
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || length > remaining) {
+        codePoint = 0xFFFD;
+        return 1;
+    }
+    codePoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; i++) {
+        if ((data[i] & 0xC0) != 0x80) {
+            codePoint = 0xFFFD;
+            return 1;
+        }
+        codePoint = (codePoint << 6) | (data[i] & 0x3F);
+    }
+    return length;
+}
+
+// Латинские буквы и кириллица U+0400-U+045F (заглавные U+0400-U+042F)
+LetterCase classifyLetter(uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        if (codePoint >= 'A' && codePoint <= 'Z') return UPPER_LETTER;
+        if (codePoint >= 'a' && codePoint <= 'z') return LOWER_LETTER;
+        return NOT_LETTER;
+    }
+    if (codePoint >= 0x400 && codePoint <= 0x42F) return UPPER_LETTER;
+    if (codePoint >= 0x430 && codePoint <= 0x45F) return LOWER_LETTER;
+    return NOT_LETTER;
+}
+
+uint32_t toLowerLetter(uint32_t codePoint) {
+    if (codePoint >= 'A' && codePoint <= 'Z') return codePoint + 32;
+    if (codePoint >= 0x400 && codePoint <= 0x40F) return codePoint + 0x50;
+    if (codePoint >= 0x410 && codePoint <= 0x42F) return codePoint + 0x20;
+    return codePoint;
+}
+
+// Записывает двухбайтовый символ UTF-8 (U+0080-U+07FF)
+inline void encodeUtf8Pair(uint32_t codePoint, char* out) {
+    out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+    out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+}
+
+// Разбор слова: только ли буквы, сколько заглавных и где первая из них
+struct WordInfo {
+    bool onlyLetters;
+    int stresses;
+    int firstStress;
+};
+
+// Посимвольный разбор; в проверке текстового файла ASCII-слова классифицируются
+// сразу по всему фрагменту (см. classifyBlock), сюда попадают остальные
+WordInfo analyzeWord(const string& word) {
+    WordInfo info = {true, 0, -1};
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(word.data());
+    size_t length = word.length();
+    size_t i = 0;
+    while (i < length) {
+        uint32_t codePoint;
+        size_t step = data[i] < 0x80 ? (codePoint = data[i], 1) : decodeUtf8(data + i, length - i, codePoint);
+        LetterCase letterCase = classifyLetter(codePoint);
+        if (letterCase == NOT_LETTER) {
+            info.onlyLetters = false;
+            return info;
+        }
+        if (letterCase == UPPER_LETTER) {
+            if (info.firstStress == -1) info.firstStress = static_cast<int>(i);
+            info.stresses++;
+        }
+        i += step;
+    }
+    return info;
+}
+
+// Слово в нижнем регистре (ударение в словах обозначается заглавной буквой)
+string toLowerWord(const string& word) {
+    string lower = word;
+    size_t i = 0;
+    while (i < lower.length()) {
+        unsigned char c = static_cast<unsigned char>(lower[i]);
+        if (c < 0x80) {
+            if (c >= 'A' && c <= 'Z') lower[i] = static_cast<char>(c + 32);
+            i++;
+            continue;
+        }
+        uint32_t codePoint;
+        size_t step = decodeUtf8(reinterpret_cast<const unsigned char*>(lower.data()) + i,
+                                 lower.length() - i, codePoint);
+        uint32_t lowerCodePoint = toLowerLetter(codePoint);
+        if (lowerCodePoint != codePoint) {
+            encodeUtf8Pair(lowerCodePoint, &lower[i]);
+        }
+        i += step;
+    }
+    return lower;
+}
+
+// Позиция единственной заглавной буквы или -1, если ударений не ровно одно
+int stressPosition(const string& word) {
+    WordInfo info = analyzeWord(word);
+    return info.stresses == 1 ? info.firstStress : -1;
+}
+
+// Допустимые позиции ударения найденного слова (указывают внутрь словаря)
+struct StressPositions {
+    bool found;
+    const uint16_t* data;
+    size_t count;
     
-    WordDictionary() {
-        words = createSet(10);
+    bool accepts(int position) const {
+        for (size_t i = 0; i < count; i++) {
+            if (data[i] == position) return true;
+        }
+        return false;
     }
+};
+
+// Словарь ударений: ключ - слово в нижнем регистре, значение - допустимые позиции
+// ударения (у слова может быть несколько вариантов). Поиск - одна проба хеш-таблицы.
+struct WordDictionary {
+    unordered_map<string, vector<uint16_t>> words;
     
-    ~WordDictionary() {
-        destroySet(words);
+    void reserve(size_t count) {
+        words.reserve(count);
     }
     
     void addWord(const string& word) {
-        setInsert(words, word);
+        vector<uint16_t>& positions = words[toLowerWord(word)];
+        int position = stressPosition(word);
+        if (position != -1 && find(positions.begin(), positions.end(), position) == positions.end()) {
+            positions.push_back(static_cast<uint16_t>(position));
+        }
     }
     
-    bool contains(const string& word) {
-        return setContains(words, word);
+    StressPositions findStresses(const string& word) const {
+        auto it = words.find(toLowerWord(word));
+        if (it == words.end()) return StressPositions{false, nullptr, 0};
+        return StressPositions{true, it->second.data(), it->second.size()};
+    }
+    
+    bool contains(const string& word) const {
+        return findStresses(word).found;
     }
 };
 
-int countStresses(const string& word) {
-    int count = 0;
-    for (char c : word) {
-        if (isupper(c)) count++;
+// Результат проверки слова текста
+enum StressCheck {
+    STRESS_OK,
+    STRESS_WRONG_IN_DICTIONARY,   // слово есть в словаре, но ударение не на том слоге
+    STRESS_WRONG_COUNT            // слова нет в словаре и ударений не ровно одно
+};
+
+// Слово из словаря должно совпадать с одним из его вариантов ударения,
+// для остальных слов достаточно ровно одного ударения. Если в словаре слово
+// записано без ударения или с несколькими (вариантов нет), тоже действует
+// правило одного ударения, как до появления вариантов. position - позиция
+// единственного ударения слова или -1.
+template <typename Dictionary>
+StressCheck checkWord(const Dictionary& dict, const string& word, int position) {
+    StressPositions accepted = dict.findStresses(word);
+    if (accepted.found) {
+        if (position == -1 || (accepted.count > 0 && !accepted.accepts(position))) {
+            return STRESS_WRONG_IN_DICTIONARY;
+        }
+        return STRESS_OK;
     }
-    return count;
+    return position == -1 ? STRESS_WRONG_COUNT : STRESS_OK;
+}
+
+// Проверка слова с подсчетом ударений
+template <typename Dictionary>
+StressCheck checkWord(const Dictionary& dict, const string& word) {
+    return checkWord(dict, word, stressPosition(word));
+}
+
+int countStresses(const string& word) {
+    return analyzeWord(word).stresses;
 }
 
 bool containsOnlyLetters(const string& word) {
-    for (char c : word) {
-        if (!isalpha(c)) return false;
+    return analyzeWord(word).onlyLetters;
+}
+
+// Резидентная память процесса в байтах (по /proc/self/statm)
+size_t residentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Минимизированный DAWG словаря ударений (слова в нижнем регистре).
+// Каждое ребро хранит число слов, предшествующих ему в лексикографическом порядке,
+// поэтому проход по автомату дает номер слова, а по номеру берутся позиции ударений.
+// Файл: заголовок, узлы, ребра, смещения позиций (wordCount + 1), позиции (uint16).
+struct DawgHeader {
+    char magic[4];
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint32_t wordCount;
+    uint32_t positionCount;
+    uint32_t reserved;
+};
+
+struct DawgNode {
+    uint32_t firstEdge;
+    uint16_t edgeCount;
+    uint8_t final;
+    uint8_t reserved;
+};
+
+struct DawgEdge {
+    uint32_t target;
+    uint32_t wordsBefore;
+    uint8_t label;
+    uint8_t reserved[3];
+};
+
+// Узел автомата во время построения
+struct DawgBuildNode {
+    bool final;
+    vector<pair<uint8_t, uint32_t>> edges;
+};
+
+// Построение по алгоритму Дацюка для отсортированных слов: после каждого слова
+// неизменяемый хвост предыдущего слова заменяется эквивалентными узлами из реестра
+struct DawgBuilder {
+    vector<DawgBuildNode> nodes;
+    unordered_map<string, uint32_t> registry;
+    vector<uint32_t> path;   // узлы последнего добавленного слова
+    string previous;
+    
+    DawgBuilder() {
+        nodes.push_back(DawgBuildNode{false, {}});
+        path.push_back(0);
+    }
+    
+    string signature(uint32_t node) const {
+        string key(1, nodes[node].final ? '1' : '0');
+        for (const auto& edge : nodes[node].edges) {
+            key += static_cast<char>(edge.first);
+            key.append(reinterpret_cast<const char*>(&edge.second), sizeof(edge.second));
+        }
+        return key;
+    }
+    
+    // Сворачивает узлы пути глубже depth в эквивалентные зарегистрированные
+    void minimize(size_t depth) {
+        while (path.size() > depth + 1) {
+            uint32_t child = path.back();
+            path.pop_back();
+            string key = signature(child);
+            auto it = registry.find(key);
+            if (it != registry.end()) {
+                nodes[path.back()].edges.back().second = it->second;
+                // Узел-дубликат больше недостижим; при сохранении он отбрасывается
+                vector<pair<uint8_t, uint32_t>>().swap(nodes[child].edges);
+            } else {
+                registry.emplace(key, child);
+            }
+        }
+    }
+    
+    void add(const string& word) {
+        size_t common = 0;
+        while (common < word.length() && common < previous.length() && word[common] == previous[common]) {
+            common++;
+        }
+        minimize(common);
+        for (size_t i = common; i < word.length(); i++) {
+            uint32_t child = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(DawgBuildNode{false, {}});
+            nodes[path.back()].edges.push_back(make_pair(static_cast<uint8_t>(word[i]), child));
+            path.push_back(child);
+        }
+        nodes[path.back()].final = true;
+        previous = word;
+    }
+    
+    void finish() {
+        minimize(0);
+    }
+};
+
+// Записывает словарь ударений в файл DAWG
+bool saveDawg(const string& filename, const WordDictionary& dict) {
+    vector<const pair<const string, vector<uint16_t>>*> entries;
+    entries.reserve(dict.words.size());
+    for (const auto& entry : dict.words) {
+        entries.push_back(&entry);
+    }
+    sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    
+    DawgBuilder builder;
+    for (const auto* entry : entries) {
+        builder.add(entry->first);
+    }
+    builder.finish();
+    
+    // После минимизации в векторе остались дыры от удаленных узлов: перенумеровываем
+    // достижимые узлы и считаем число слов в правом языке каждого узла
+    vector<uint32_t> newIndex(builder.nodes.size(), UINT32_MAX);
+    vector<uint32_t> order;
+    vector<uint32_t> stack(1, 0);
+    newIndex[0] = 0;
+    order.push_back(0);
+    while (!stack.empty()) {
+        uint32_t node = stack.back();
+        stack.pop_back();
+        for (const auto& edge : builder.nodes[node].edges) {
+            if (newIndex[edge.second] == UINT32_MAX) {
+                newIndex[edge.second] = static_cast<uint32_t>(order.size());
+                order.push_back(edge.second);
+                stack.push_back(edge.second);
+            }
+        }
+    }
+    
+    vector<uint32_t> wordCounts(builder.nodes.size(), 0);
+    vector<bool> counted(builder.nodes.size(), false);
+    // Обход в обратном топологическом порядке (итеративный DFS с выходом из узла)
+    vector<pair<uint32_t, size_t>> dfs(1, make_pair(0u, size_t(0)));
+    while (!dfs.empty()) {
+        uint32_t node = dfs.back().first;
+        size_t& next = dfs.back().second;
+        const auto& edges = builder.nodes[node].edges;
+        if (next < edges.size()) {
+            uint32_t child = edges[next++].second;
+            if (!counted[child]) dfs.push_back(make_pair(child, size_t(0)));
+            continue;
+        }
+        uint32_t total = builder.nodes[node].final ? 1 : 0;
+        for (const auto& edge : edges) total += wordCounts[edge.second];
+        wordCounts[node] = total;
+        counted[node] = true;
+        dfs.pop_back();
+    }
+    
+    vector<DawgNode> nodes(order.size());
+    vector<DawgEdge> edges;
+    for (size_t i = 0; i < order.size(); i++) {
+        const DawgBuildNode& source = builder.nodes[order[i]];
+        nodes[i] = DawgNode{static_cast<uint32_t>(edges.size()), static_cast<uint16_t>(source.edges.size()),
+                            static_cast<uint8_t>(source.final), 0};
+        uint32_t before = source.final ? 1 : 0;
+        for (const auto& edge : source.edges) {
+            edges.push_back(DawgEdge{newIndex[edge.second], before, edge.first, {0, 0, 0}});
+            before += wordCounts[edge.second];
+        }
+    }
+    
+    vector<uint32_t> offsets;
+    vector<uint16_t> positions;
+    offsets.reserve(entries.size() + 1);
+    for (const auto* entry : entries) {
+        offsets.push_back(static_cast<uint32_t>(positions.size()));
+        positions.insert(positions.end(), entry->second.begin(), entry->second.end());
+    }
+    offsets.push_back(static_cast<uint32_t>(positions.size()));
+    
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для записи" << endl;
+        return false;
+    }
+    DawgHeader header = {{'S', 'D', 'W', 'G'}, static_cast<uint32_t>(nodes.size()),
+                         static_cast<uint32_t>(edges.size()), static_cast<uint32_t>(entries.size()),
+                         static_cast<uint32_t>(positions.size()), 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(DawgNode));
+    file.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(DawgEdge));
+    file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(uint16_t));
+    return file.good();
+}
+
+// Словарь ударений, отображенный из файла DAWG; поиск идет по автомату без выделения памяти
+struct DawgDictionary {
+    void* mapping;
+    size_t mappingSize;
+    const DawgHeader* header;
+    const DawgNode* nodes;
+    const DawgEdge* edges;
+    const uint32_t* offsets;
+    const uint16_t* positions;
+    
+    DawgDictionary() : mapping(MAP_FAILED), mappingSize(0), header(nullptr), nodes(nullptr),
+                       edges(nullptr), offsets(nullptr), positions(nullptr) {}
+    
+    ~DawgDictionary() {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mappingSize);
+        }
+    }
+    
+    bool open(const string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(DawgHeader)) {
+            cerr << "Ошибка: файл " << filename << " не является словарем DAWG" << endl;
+            close(fd);
+            return false;
+        }
+        mappingSize = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            cerr << "Ошибка: не удалось отобразить файл " << filename << " в память" << endl;
+            return false;
+        }
+        
+        const char* data = static_cast<const char*>(mapping);
+        header = reinterpret_cast<const DawgHeader*>(data);
+        size_t expected = sizeof(DawgHeader) + header->nodeCount * sizeof(DawgNode) +
+                          header->edgeCount * sizeof(DawgEdge) +
+                          (static_cast<size_t>(header->wordCount) + 1) * sizeof(uint32_t) +
+                          header->positionCount * sizeof(uint16_t);
+        if (memcmp(header->magic, "SDWG", 4) != 0 || header->nodeCount == 0 || expected != mappingSize) {
+            cerr << "Ошибка: файл " << filename << " не является словарем DAWG или поврежден" << endl;
+            return false;
+        }
+        data += sizeof(DawgHeader);
+        nodes = reinterpret_cast<const DawgNode*>(data);
+        data += header->nodeCount * sizeof(DawgNode);
+        edges = reinterpret_cast<const DawgEdge*>(data);
+        data += header->edgeCount * sizeof(DawgEdge);
+        offsets = reinterpret_cast<const uint32_t*>(data);
+        data += (static_cast<size_t>(header->wordCount) + 1) * sizeof(uint32_t);
+        positions = reinterpret_cast<const uint16_t*>(data);
+        if (!validate()) {
+            cerr << "Ошибка: файл " << filename << " не является словарем DAWG или поврежден" << endl;
+            return false;
+        }
+        return true;
+    }
+    
+    // Проверка ссылок внутри файла: после нее поиск не выходит за отображение,
+    // даже если файл испорчен (номер слова дополнительно проверяется при поиске)
+    bool validate() const {
+        for (uint32_t i = 0; i < header->nodeCount; i++) {
+            if (static_cast<uint64_t>(nodes[i].firstEdge) + nodes[i].edgeCount > header->edgeCount) {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->edgeCount; i++) {
+            if (edges[i].target >= header->nodeCount) return false;
+        }
+        if (offsets[0] != 0 || offsets[header->wordCount] != header->positionCount) return false;
+        for (uint32_t i = 0; i < header->wordCount; i++) {
+            if (offsets[i] > offsets[i + 1]) return false;
+        }
+        return true;
+    }
+    
+    StressPositions findStresses(const string& word) const {
+        uint32_t node = 0;
+        uint32_t index = 0;
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(word.data());
+        size_t length = word.length();
+        size_t i = 0;
+        while (i < length) {
+            // Переход по байтам буквы в нижнем регистре (в UTF-8 - один или два байта)
+            unsigned char lowered[4];
+            size_t step;
+            if (data[i] < 0x80) {
+                lowered[0] = static_cast<unsigned char>(data[i] >= 'A' && data[i] <= 'Z' ? data[i] + 32 : data[i]);
+                step = 1;
+            } else {
+                uint32_t codePoint;
+                step = decodeUtf8(data + i, length - i, codePoint);
+                memcpy(lowered, data + i, step);
+                uint32_t lowerCodePoint = toLowerLetter(codePoint);
+                if (lowerCodePoint != codePoint) {
+                    encodeUtf8Pair(lowerCodePoint, reinterpret_cast<char*>(lowered));
+                }
+            }
+            for (size_t b = 0; b < step; b++) {
+                uint8_t label = lowered[b];
+                const DawgEdge* edge = edges + nodes[node].firstEdge;
+                const DawgEdge* end = edge + nodes[node].edgeCount;
+                while (edge != end && edge->label < label) edge++;
+                if (edge == end || edge->label != label) return StressPositions{false, nullptr, 0};
+                index += edge->wordsBefore;
+                node = edge->target;
+            }
+            i += step;
+        }
+        if (!nodes[node].final || index >= header->wordCount) return StressPositions{false, nullptr, 0};
+        return StressPositions{true, positions + offsets[index], offsets[index + 1] - offsets[index]};
+    }
+    
+    bool contains(const string& word) const {
+        return findStresses(word).found;
+    }
+};
+
+// Читает словарь из файла слов (через пробелы или переводы строк)
+bool loadWordList(const string& filename, WordDictionary& dict) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+        return false;
+    }
+    string word;
+    while (file >> word) {
+        if (!containsOnlyLetters(word)) {
+            cerr << "Ошибка: слово должно содержать только буквы! Получено: '" << word << "'" << endl;
+            return false;
+        }
+        dict.addWord(word);
     }
     return true;
 }
 
-int main() {
+// Строит DAWG из файла слов и сравнивает память с хеш-словарем
+int runBuildDawg(const string& wordsFile, const string& dawgFile) {
+    size_t residentBefore = residentBytes();
+    WordDictionary dict;
+    if (!loadWordList(wordsFile, dict)) {
+        return 1;
+    }
+    size_t hashBytes = residentBytes() - residentBefore;
+    
+    if (!saveDawg(dawgFile, dict)) {
+        cerr << "Ошибка при записи словаря в файл " << dawgFile << endl;
+        return 1;
+    }
+    
+    DawgDictionary dawg;
+    if (!dawg.open(dawgFile)) {
+        return 1;
+    }
+    size_t rawBytes = 0;
+    for (const auto& entry : dict.words) {
+        rawBytes += entry.first.length() + 1;
+        // Проверка: автомат должен находить каждое слово с теми же позициями ударения
+        StressPositions found = dawg.findStresses(entry.first);
+        if (!found.found || found.count != entry.second.size() ||
+            !equal(entry.second.begin(), entry.second.end(), found.data)) {
+            cerr << "Ошибка: DAWG не совпадает со словарем на слове '" << entry.first << "'" << endl;
+            return 1;
+        }
+    }
+    
+    cout << "Слов: " << dict.words.size() << ", узлов: " << dawg.header->nodeCount
+         << ", ребер: " << dawg.header->edgeCount << endl;
+    cout << "Исходные слова: " << rawBytes / 1024 << " КБ" << endl;
+    cout << "Хеш-словарь (резидентно): " << hashBytes / 1024 << " КБ" << endl;
+    cout << "DAWG (файл, отображается в память): " << dawg.mappingSize / 1024 << " КБ" << endl;
+    return 0;
+}
+
+// Случайное слово из строчных латинских букв с одной заглавной (ударной) буквой
+string randomStressedWord(mt19937& generator) {
+    uniform_int_distribution<int> lengthDist(4, 12);
+    uniform_int_distribution<int> letterDist(0, 25);
+    string word(lengthDist(generator), 'a');
+    for (char& c : word) {
+        c = static_cast<char>('a' + letterDist(generator));
+    }
+    uniform_int_distribution<size_t> stressDist(0, word.length() - 1);
+    size_t stress = stressDist(generator);
+    word[stress] = static_cast<char>(toupper(word[stress]));
+    return word;
+}
+
+// Бенчмарк поиска: хеш-словарь против линейного SetArray на словаре из dictionarySize слов
+int runBenchmark(int dictionarySize) {
+    mt19937 generator(42);
+    vector<string> dictionaryWords;
+    dictionaryWords.reserve(dictionarySize);
+    for (int i = 0; i < dictionarySize; i++) {
+        dictionaryWords.push_back(randomStressedWord(generator));
+    }
+    // Половина слов текста из словаря (часть с неверным ударением), половина - новые
+    const int textSize = 1000000;
+    vector<string> text;
+    text.reserve(textSize);
+    uniform_int_distribution<int> pick(0, dictionarySize - 1);
+    for (int i = 0; i < textSize; i++) {
+        text.push_back(i % 2 == 0 ? dictionaryWords[pick(generator)] : randomStressedWord(generator));
+    }
+    
+    auto start = chrono::steady_clock::now();
+    WordDictionary dict;
+    dict.reserve(dictionarySize);
+    for (const string& word : dictionaryWords) {
+        dict.addWord(word);
+    }
+    auto built = chrono::steady_clock::now();
+    int errors = 0;
+    for (const string& word : text) {
+        errors += checkWord(dict, word) != STRESS_OK;
+    }
+    auto checked = chrono::steady_clock::now();
+    
+    double buildSeconds = chrono::duration<double>(built - start).count();
+    double checkSeconds = chrono::duration<double>(checked - built).count();
+    cout << "Словарь: " << dictionarySize << " слов, текст: " << textSize << " слов" << endl;
+    cout << "Хеш-словарь: построение " << buildSeconds << " с, проверка "
+         << textSize / checkSeconds << " слов/с, ошибок " << errors << endl;
+    
+    // Линейный SetArray: строится без проверки дубликатов (setInsert квадратичен),
+    // поиск измеряется на небольшой выборке
+    SetArray* linear = createSet(dictionarySize);
+    for (const string& word : dictionaryWords) {
+        linear->data[linear->size++] = word;
+    }
+    const int sampleSize = 200;
+    auto sampleStart = chrono::steady_clock::now();
+    int found = 0;
+    for (int i = 0; i < sampleSize; i++) {
+        found += setContains(linear, text[i]);
+    }
+    double sampleSeconds = chrono::duration<double>(chrono::steady_clock::now() - sampleStart).count();
+    destroySet(linear);
+    cout << "SetArray: проверка " << sampleSize / sampleSeconds << " слов/с (выборка " << sampleSize
+         << " слов, найдено " << found << ")" << endl;
+    return 0;
+}
+
+// Проверяет строку текста по словарю; возвращает код завершения программы
+template <typename Dictionary>
+int checkText(const Dictionary& dict, const string& line) {
+    stringstream ss(line);
+    string word;
+    int errors = 0;
+    int wordCount = 0;
+
+    while (ss >> word) {
+        wordCount++;
+        
+        if (!containsOnlyLetters(word)) {
+            cout << "Ошибка: слово в тексте содержит небуквенные символы: '" << word << "'" << endl;
+            return 1;
+        }
+
+        StressCheck result = checkWord(dict, word);
+        
+        if (result == STRESS_WRONG_IN_DICTIONARY) {
+            errors++;
+            cout << "Ошибка в слове " << word << " (есть в словаре, но ударение неверное)" << endl;
+        } else if (result == STRESS_WRONG_COUNT) {
+            errors++;
+            cout << "Ошибка в слове " << word << " (нет в словаре, ударение должно быть одно)" << endl;
+        }
+    }
+
+    if (wordCount == 0) {
+        cout << "Ошибка: в тексте нет слов для проверки!" << endl;
+        return 1;
+    }
+
+    cout << "Общее количество ошибок: " << errors << endl;
+    return 0;
+}
+
+// Размер фрагмента текста при потоковой проверке файла (байт)
+const size_t TEXT_CHUNK_SIZE = 4 << 20;
+
+// Итоги проверки фрагмента текста; ошибки накапливаются в буфере, а не печатаются сразу
+struct ChunkReport {
+    string output;
+    long long words;
+    long long errors;
+    long long nonLetterWords;
+};
+
+// Битовые маски блока текста до 16 байт: бит i относится к байту i
+struct BlockMasks {
+    uint32_t space;      // пробельные символы (как isspace)
+    uint32_t letter;     // латинские буквы
+    uint32_t upper;      // заглавные латинские буквы
+    uint32_t nonAscii;   // байты UTF-8 от 0x80 (разбираются посимвольно)
+};
+
+// Классификация блока: полный блок - SSE2-сравнениями, хвост фрагмента - побайтно
+inline BlockMasks classifyBlock(const unsigned char* data, size_t length) {
+    BlockMasks masks = {0, 0, 0, 0};
+#if defined(__SSE2__)
+    if (length == 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        const __m128i maxLetter = _mm_set1_epi8(25);
+        __m128i lower = _mm_sub_epi8(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i upper = _mm_sub_epi8(bytes, _mm_set1_epi8('A'));
+        // Пробельные: ' ' и 0x09-0x0D
+        __m128i control = _mm_sub_epi8(bytes, _mm_set1_epi8(0x09));
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')),
+                                     _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control));
+        masks.space = static_cast<uint32_t>(_mm_movemask_epi8(space));
+        masks.nonAscii = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+        masks.letter = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(lower, maxLetter), lower)));
+        masks.upper = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(upper, maxLetter), upper)));
+        // Байты от 0x80 не считаются латинскими буквами
+        masks.letter &= ~masks.nonAscii;
+        masks.upper &= ~masks.nonAscii;
+        return masks;
+    }
+#endif
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = data[i];
+        uint32_t bit = 1u << i;
+        if (c >= 0x80) {
+            masks.nonAscii |= bit;
+        } else if (c == ' ' || (c >= 0x09 && c <= 0x0D)) {
+            masks.space |= bit;
+        } else if (c >= 'A' && c <= 'Z') {
+            masks.letter |= bit;
+            masks.upper |= bit;
+        } else if (c >= 'a' && c <= 'z') {
+            masks.letter |= bit;
+        }
+    }
+    return masks;
+}
+
+// Слово, собираемое из блоков: для ASCII-слов разбор готов к концу слова,
+// слова с байтами от 0x80 разбираются заново посимвольно (analyzeWord)
+struct PendingWord {
+    size_t start;
+    bool nonAscii;
+    WordInfo info;
+};
+
+// Проверяет все слова фрагмента; слова с небуквенными символами учитываются и пропускаются.
+// Фрагмент идет блоками по 16 байт: границы слов, буквы и ударения берутся из масок блока,
+// так что векторная классификация работает для слов любой длины.
+template <typename Dictionary>
+void checkChunk(const Dictionary& dict, const char* data, size_t length, ChunkReport& report) {
+    report.output.clear();
+    report.words = report.errors = report.nonLetterWords = 0;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    string word;
+    PendingWord pending = {0, false, {true, 0, -1}};
+    bool inWord = false;
+    
+    auto finishWord = [&](size_t end) {
+        word.assign(data + pending.start, end - pending.start);
+        report.words++;
+        WordInfo info = pending.nonAscii ? analyzeWord(word) : pending.info;
+        if (!info.onlyLetters) {
+            report.nonLetterWords++;
+            report.output += "Пропущено слово с небуквенными символами: '" + word + "'\n";
+            return;
+        }
+        
+        StressCheck result = checkWord(dict, word, info.stresses == 1 ? info.firstStress : -1);
+        if (result == STRESS_WRONG_IN_DICTIONARY) {
+            report.errors++;
+            report.output += "Ошибка в слове " + word + " (есть в словаре, но ударение неверное)\n";
+        } else if (result == STRESS_WRONG_COUNT) {
+            report.errors++;
+            report.output += "Ошибка в слове " + word + " (нет в словаре, ударение должно быть одно)\n";
+        }
+    };
+    
+    for (size_t base = 0; base < length; base += 16) {
+        size_t blockLength = min<size_t>(16, length - base);
+        BlockMasks masks = classifyBlock(bytes + base, blockLength);
+        uint32_t all = blockLength == 16 ? 0xFFFFu : (1u << blockLength) - 1;
+        size_t i = 0;
+        while (i < blockLength) {
+            uint32_t rest = all & ~((1u << i) - 1);
+            if (!inWord) {
+                uint32_t starts = ~masks.space & rest;
+                if (starts == 0) break;
+                i = static_cast<size_t>(__builtin_ctz(starts));
+                pending = PendingWord{base + i, false, {true, 0, -1}};
+                inWord = true;
+                continue;
+            }
+            uint32_t spaces = masks.space & rest;
+            size_t end = spaces ? static_cast<size_t>(__builtin_ctz(spaces)) : blockLength;
+            uint32_t segment = rest & (end < 32 ? (1u << end) - 1 : all);
+            if (masks.nonAscii & segment) {
+                pending.nonAscii = true;
+            } else if (!pending.nonAscii) {
+                if ((masks.letter & segment) != segment) pending.info.onlyLetters = false;
+                uint32_t upper = masks.upper & segment;
+                if (upper) {
+                    if (pending.info.firstStress == -1) {
+                        pending.info.firstStress = static_cast<int>(base + __builtin_ctz(upper) - pending.start);
+                    }
+                    pending.info.stresses += __builtin_popcount(upper);
+                }
+            }
+            if (end < blockLength) {
+                finishWord(base + end);
+                inWord = false;
+            }
+            i = end;
+        }
+    }
+    if (inWord) {
+        finishWord(length);
+    }
+}
+
+// Проверка текстового файла: файл читается фрагментами, разрезанными по границам слов,
+// пачка из threadCount фрагментов проверяется параллельно по общему словарю (только чтение),
+// а отчеты выводятся в исходном порядке
+template <typename Dictionary>
+int checkTextFile(const Dictionary& dict, const string& filename, int threadCount) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+        return 1;
+    }
+    
+    auto start = chrono::steady_clock::now();
+    vector<string> chunks(threadCount);
+    vector<ChunkReport> reports(threadCount);
+    string carry;   // незаконченное слово с конца предыдущего фрагмента
+    long long words = 0, errors = 0, nonLetterWords = 0;
+    bool eof = false;
+    
+    while (!eof) {
+        int filled = 0;
+        while (filled < threadCount && !eof) {
+            string& chunk = chunks[filled];
+            chunk.swap(carry);
+            carry.clear();
+            size_t used = chunk.size();
+            chunk.resize(used + TEXT_CHUNK_SIZE);
+            file.read(&chunk[used], TEXT_CHUNK_SIZE);
+            chunk.resize(used + static_cast<size_t>(file.gcount()));
+            eof = !file;
+            
+            if (!eof) {
+                // Перенесенное начало (до used) пробелов не содержит, ищем только в новых байтах
+                size_t cut = chunk.size();
+                while (cut > used && !isspace(static_cast<unsigned char>(chunk[cut - 1]))) cut--;
+                if (cut > used) {
+                    carry.assign(chunk, cut, string::npos);
+                    chunk.resize(cut);
+                } else {
+                    // Пробелов нет во всем фрагменте: слово еще не закончилось, фрагмент
+                    // целиком уходит в перенос и дочитывается до пробела или конца файла
+                    carry.swap(chunk);
+                    chunk.clear();
+                }
+            }
+            if (!chunk.empty()) filled++;
+        }
+        
+        vector<thread> workers;
+        for (int t = 1; t < filled; t++) {
+            workers.emplace_back([&, t]() {
+                checkChunk(dict, chunks[t].data(), chunks[t].size(), reports[t]);
+            });
+        }
+        if (filled > 0) {
+            checkChunk(dict, chunks[0].data(), chunks[0].size(), reports[0]);
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        
+        for (int t = 0; t < filled; t++) {
+            cout << reports[t].output;
+            words += reports[t].words;
+            errors += reports[t].errors;
+            nonLetterWords += reports[t].nonLetterWords;
+        }
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Проверено слов: " << words << " за " << seconds << " с ("
+         << (seconds > 0 ? words / seconds : words) << " слов/с)" << '\n';
+    cout << "Пропущено слов с небуквенными символами: " << nonLetterWords << '\n';
+    cout << "Общее количество ошибок: " << errors << endl;
+    return words == 0 ? 1 : 0;
+}
+
+void printUsage(const string& programName) {
+    cout << "Использование: " << programName << "                    (словарь и текст с клавиатуры)" << endl;
+    cout << "       " << programName << " --dawg <файл>       (словарь из файла DAWG, текст с клавиатуры)" << endl;
+    cout << "       " << programName << " --build-dawg <файл слов> --dawg <файл>" << endl;
+    cout << "       " << programName << " --text <файл текста> (--dawg <файл> | --words <файл слов>)"
+         << " [--threads <число>]" << endl;
+    cout << "       " << programName << " --bench <размер словаря>" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string dawgFile, wordsFile, dictionaryFile, textFile;
+    int benchSize = 0;
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bench" && i + 1 < argc) {
+            benchSize = atoi(argv[++i]);
+            if (benchSize <= 0) {
+                cerr << "Ошибка: размер словаря должен быть положительным" << endl;
+                return 1;
+            }
+        } else if (arg == "--dawg" && i + 1 < argc) {
+            dawgFile = argv[++i];
+        } else if (arg == "--build-dawg" && i + 1 < argc) {
+            wordsFile = argv[++i];
+        } else if (arg == "--words" && i + 1 < argc) {
+            dictionaryFile = argv[++i];
+        } else if (arg == "--text" && i + 1 < argc) {
+            textFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+            if (threadCount <= 0) {
+                cerr << "Ошибка: число потоков должно быть положительным" << endl;
+                return 1;
+            }
+        } else {
+            cerr << "Ошибка: неизвестный аргумент: " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (benchSize > 0) {
+        return runBenchmark(benchSize);
+    }
+    if (!wordsFile.empty()) {
+        if (dawgFile.empty()) {
+            cerr << "Ошибка: для --build-dawg нужен --dawg <файл>" << endl;
+            return 1;
+        }
+        return runBuildDawg(wordsFile, dawgFile);
+    }
+    
+    if (!textFile.empty()) {
+        ios::sync_with_stdio(false);
+        if (!dawgFile.empty()) {
+            DawgDictionary dawg;
+            if (!dawg.open(dawgFile)) {
+                return 1;
+            }
+            return checkTextFile(dawg, textFile, threadCount);
+        }
+        if (dictionaryFile.empty()) {
+            cerr << "Ошибка: для --text нужен словарь --dawg или --words" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        WordDictionary dict;
+        if (!loadWordList(dictionaryFile, dict)) {
+            return 1;
+        }
+        return checkTextFile(dict, textFile, threadCount);
+    }
+    
     cout << "Проверка ударений" << endl;
     
+    string line;
+    if (!dawgFile.empty()) {
+        DawgDictionary dawg;
+        if (!dawg.open(dawgFile)) {
+            return 1;
+        }
+        cout << "Словарь загружен из " << dawgFile << " (" << dawg.header->wordCount << " слов)" << endl;
+        cout << "Введите текст для проверки: ";
+        if (!getline(cin, line)) {
+            cout << "Ошибка при вводе текста!" << endl;
+            return 1;
+        }
+        if (line.empty()) {
+            cout << "Ошибка: текст не может быть пустым!" << endl;
+            return 1;
+        }
+        return checkText(dawg, line);
+    }
+    
     int n;
     cout << "Введите количество слов в словаре: ";
     
@@ -58,6 +1022,7 @@ int main() {
     }
 
     WordDictionary dict;
+    dict.reserve(n);
     string word;
     cout << "Введите слова словаря:" << endl;
     
@@ -76,7 +1041,6 @@ int main() {
     }
 
     cin.ignore();
-    string line;
     cout << "Введите текст для проверки: ";
     
     if (!getline(cin, line)) {
@@ -89,38 +1053,5 @@ int main() {
         return 1;
     }
 
-    stringstream ss(line);
-    int errors = 0;
-    int wordCount = 0;
-
-    while (ss >> word) {
-        wordCount++;
-        
-        if (!containsOnlyLetters(word)) {
-            cout << "Ошибка: слово в тексте содержит небуквенные символы: '" << word << "'" << endl;
-            return 1;
-        }
-
-        int stresses = countStresses(word);
-        
-        if (dict.contains(word)) {
-            if (stresses != 1) {
-                errors++;
-                cout << "Ошибка в слове " << word << " (есть в словаре, но ударение неверное)" << endl;
-            }
-        } else {
-            if (stresses != 1) {
-                errors++;
-                cout << "Ошибка в слове " << word << " (нет в словаре, ударение должно быть одно)" << endl;
-            }
-        }
-    }
-
-    if (wordCount == 0) {
-        cout << "Ошибка: в тексте нет слов для проверки!" << endl;
-        return 1;
-    }
-
-    cout << "Общее количество ошибок: " << errors << endl;
-    return 0;
+    return checkText(dict, line);
 }
\ No newline at end of file
@@ -1,37 +1,92 @@
 #include <iostream>
 #include <algorithm>
 #include <climits>
+#include <cmath>
 #include <limits>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <unistd.h>
+#include <cstdio>
+#include <charconv>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <sstream>
 
 using namespace std;
 
 struct Node {
     int value;
+    int height;   // поддерживается только при вставке через TrackedBst
     Node* left;
     Node* right;
-    Node(int v) : value(v), left(nullptr), right(nullptr) {}
+    Node(int v) : value(v), height(1), left(nullptr), right(nullptr) {}
 };
 
+// Все операции над наивным деревом итеративные: вырожденное дерево глубиной в
+// миллионы узлов не должно переполнять стек потока
+
 Node* insert(Node* root, int value) {
-    if (!root) return new Node(value);
-    if (value < root->value)
-        root->left = insert(root->left, value);
-    else
-        root->right = insert(root->right, value);
+    Node** link = &root;
+    while (*link) {
+        link = value < (*link)->value ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(value);
     return root;
 }
 
-int checkBalanced(Node* root, bool& isBalanced) {
+// Обход в обратном порядке с явным стеком в куче. Если задан cancelled, флаг
+// периодически проверяется, и обход прекращается, как только другой поток нашел дисбаланс.
+int checkBalanced(Node* root, bool& isBalanced, const atomic<bool>* cancelled) {
     if (!root || !isBalanced) return 0;
     
-    int leftHeight = checkBalanced(root->left, isBalanced);
-    int rightHeight = checkBalanced(root->right, isBalanced);
+    struct Frame {
+        Node* node;
+        int stage;        // 0 - идем влево, 1 - идем вправо, 2 - оба поддерева готовы
+        int leftHeight;
+    };
+    vector<Frame> stack;
+    stack.push_back(Frame{root, 0, 0});
+    int childHeight = 0;   // высота только что обработанного поддерева
     
-    if (abs(leftHeight - rightHeight) > 1) {
-        isBalanced = false;
-    }
+    size_t steps = 0;
     
-    return 1 + max(leftHeight, rightHeight);
+    while (!stack.empty()) {
+        if (cancelled && (++steps & 0xFFFF) == 0 && cancelled->load(memory_order_relaxed)) {
+            return 0;
+        }
+        Frame& frame = stack.back();
+        if (frame.stage == 0) {
+            frame.stage = 1;
+            childHeight = 0;
+            if (frame.node->left) {
+                stack.push_back(Frame{frame.node->left, 0, 0});
+            }
+        } else if (frame.stage == 1) {
+            frame.stage = 2;
+            frame.leftHeight = childHeight;
+            childHeight = 0;
+            if (frame.node->right) {
+                stack.push_back(Frame{frame.node->right, 0, 0});
+            }
+        } else {
+            if (abs(frame.leftHeight - childHeight) > 1) {
+                isBalanced = false;
+                return 0;
+            }
+            childHeight = 1 + max(frame.leftHeight, childHeight);
+            stack.pop_back();
+        }
+    }
+    return childHeight;
+}
+
+int checkBalanced(Node* root, bool& isBalanced) {
+    return checkBalanced(root, isBalanced, nullptr);
 }
 
 bool isBalancedOptimized(Node* root) {
@@ -41,13 +96,231 @@ bool isBalancedOptimized(Node* root) {
     return balanced;
 }
 
+// Освобождение поворотами: левое поддерево поворачивается вправо, пока его нет,
+// после чего узел удаляется. Дополнительная память не нужна.
 void freeTree(Node* root) {
+    while (root) {
+        if (root->left) {
+            Node* left = root->left;
+            root->left = left->right;
+            left->right = root;
+            root = left;
+        } else {
+            Node* right = root->right;
+            delete root;
+            root = right;
+        }
+    }
+}
+
+// Наивное дерево в непрерывном массиве: дети - 32-битные индексы вместо указателей.
+// Узел занимает 12 байт против 32 у Node с учетом заголовка malloc, соседние узлы
+// лежат рядом, а освобождение - одно удаление массива.
+const uint32_t ARENA_NIL = UINT32_MAX;
+
+struct ArenaNode {
+    int value;
+    uint32_t left;
+    uint32_t right;
+};
+
+struct ArenaBst {
+    vector<ArenaNode> nodes;   // корень - nodes[0]
+    
+    bool insert(int value) {
+        if (nodes.size() == ARENA_NIL) return false;   // индексы исчерпаны
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        try {
+            nodes.push_back(ArenaNode{value, ARENA_NIL, ARENA_NIL});
+        } catch (const bad_alloc& e) {
+            cerr << "Ошибка выделения памяти: " << e.what() << endl;
+            return false;
+        }
+        if (index == 0) return true;
+        
+        uint32_t current = 0;
+        while (true) {
+            ArenaNode& node = nodes[current];
+            uint32_t& link = value < node.value ? node.left : node.right;
+            if (link == ARENA_NIL) {
+                link = index;
+                return true;
+            }
+            current = link;
+        }
+    }
+    
+    bool empty() const {
+        return nodes.empty();
+    }
+    
+    // Дети всегда добавлены после родителя, поэтому высоты считаются одним проходом
+    // по массиву с конца, без рекурсии и стека
+    bool isBalanced() const {
+        vector<int> height(nodes.size(), 0);
+        for (size_t i = nodes.size(); i-- > 0; ) {
+            const ArenaNode& node = nodes[i];
+            int leftHeight = node.left == ARENA_NIL ? 0 : height[node.left];
+            int rightHeight = node.right == ARENA_NIL ? 0 : height[node.right];
+            if (abs(leftHeight - rightHeight) > 1) return false;
+            height[i] = 1 + max(leftHeight, rightHeight);
+        }
+        return true;
+    }
+};
+
+// АВЛ-дерево: сбалансированный индекс по ключу (значение, номер вставки).
+// Равные значения в наивном дереве уходят вправо, поэтому номер вставки
+// делает ключи различными и сохраняет тот же порядок.
+struct AvlNode {
+    int value;
+    int order;
+    int height;
+    AvlNode* left;
+    AvlNode* right;
+    AvlNode(int v, int o) : value(v), order(o), height(1), left(nullptr), right(nullptr) {}
+};
+
+int avlHeight(AvlNode* node) {
+    return node ? node->height : 0;
+}
+
+void avlUpdate(AvlNode* node) {
+    node->height = 1 + max(avlHeight(node->left), avlHeight(node->right));
+}
+
+AvlNode* avlRotateRight(AvlNode* node) {
+    AvlNode* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    avlUpdate(node);
+    avlUpdate(pivot);
+    return pivot;
+}
+
+AvlNode* avlRotateLeft(AvlNode* node) {
+    AvlNode* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    avlUpdate(node);
+    avlUpdate(pivot);
+    return pivot;
+}
+
+AvlNode* avlRebalance(AvlNode* node) {
+    avlUpdate(node);
+    int balance = avlHeight(node->left) - avlHeight(node->right);
+    if (balance > 1) {
+        if (avlHeight(node->left->left) < avlHeight(node->left->right)) {
+            node->left = avlRotateLeft(node->left);
+        }
+        return avlRotateRight(node);
+    }
+    if (balance < -1) {
+        if (avlHeight(node->right->right) < avlHeight(node->right->left)) {
+            node->right = avlRotateRight(node->right);
+        }
+        return avlRotateLeft(node);
+    }
+    return node;
+}
+
+// Новый ключ больше всех уже вставленных с тем же значением
+AvlNode* avlInsert(AvlNode* root, AvlNode* node) {
+    if (!root) return node;
+    if (node->value < root->value)
+        root->left = avlInsert(root->left, node);
+    else
+        root->right = avlInsert(root->right, node);
+    return avlRebalance(root);
+}
+
+void avlFree(AvlNode* root) {
     if (!root) return;
-    freeTree(root->left);
-    freeTree(root->right);
+    avlFree(root->left);
+    avlFree(root->right);
     delete root;
 }
 
+// Форма наивного BST без самого дерева. Родитель нового ключа в наивном дереве -
+// более глубокий из его соседей по порядку (предшественник или преемник), и ключ
+// становится правым ребенком предшественника или левым ребенком преемника.
+// Соседи находятся спуском по АВЛ-дереву за O(log n), поэтому отсортированный
+// ввод больше не дает O(n^2). Узлы нумеруются порядком вставки.
+struct ShadowBst {
+    AvlNode* index;
+    vector<int> naiveLeft;
+    vector<int> naiveRight;
+    vector<int> naiveDepth;
+    
+    ShadowBst() : index(nullptr) {}
+    
+    ~ShadowBst() {
+        avlFree(index);
+    }
+    
+    bool insert(int value) {
+        int order = static_cast<int>(naiveDepth.size());
+        int predecessor = -1, successor = -1;
+        AvlNode* current = index;
+        while (current) {
+            if (value < current->value) {
+                successor = current->order;
+                current = current->left;
+            } else {
+                predecessor = current->order;
+                current = current->right;
+            }
+        }
+        
+        AvlNode* node = nullptr;
+        try {
+            node = new AvlNode(value, order);
+            naiveLeft.push_back(-1);
+            naiveRight.push_back(-1);
+            naiveDepth.push_back(0);
+        } catch (const bad_alloc& e) {
+            cerr << "Ошибка выделения памяти: " << e.what() << endl;
+            delete node;
+            return false;
+        }
+        
+        int predecessorDepth = predecessor == -1 ? -1 : naiveDepth[predecessor];
+        int successorDepth = successor == -1 ? -1 : naiveDepth[successor];
+        if (predecessor != -1 && predecessorDepth >= successorDepth) {
+            naiveRight[predecessor] = order;
+            naiveDepth[order] = predecessorDepth + 1;
+        } else if (successor != -1) {
+            naiveLeft[successor] = order;
+            naiveDepth[order] = successorDepth + 1;
+        }
+        
+        index = avlInsert(index, node);
+        return true;
+    }
+    
+    bool empty() const {
+        return naiveDepth.empty();
+    }
+    
+    // Сбалансировано ли наивное дерево. Дети вставлены позже родителя, поэтому
+    // проход по номерам от последнего к первому считает высоты снизу вверх без рекурсии.
+    bool isNaiveBalanced() const {
+        int n = static_cast<int>(naiveDepth.size());
+        vector<int> height(n, 0);
+        bool balanced = true;
+        for (int i = n - 1; i >= 0; i--) {
+            int leftHeight = naiveLeft[i] == -1 ? 0 : height[naiveLeft[i]];
+            int rightHeight = naiveRight[i] == -1 ? 0 : height[naiveRight[i]];
+            if (abs(leftHeight - rightHeight) > 1) {
+                balanced = false;
+            }
+            height[i] = 1 + max(leftHeight, rightHeight);
+        }
+        return balanced;
+    }
+};
+
 // Функция для ввода числа
 bool safeInput(int& value) {
     cin >> value;
@@ -72,24 +345,795 @@ Node* createNode(int value) {
 }
 
 Node* insertWithCheck(Node* root, int value) {
-    if (!root) {
-        return createNode(value);
+    Node** link = &root;
+    while (*link) {
+        link = value < (*link)->value ? &(*link)->left : &(*link)->right;
+    }
+    Node* newNode = createNode(value);
+    if (!newNode) return nullptr; // Ошибка выделения памяти
+    *link = newNode;
+    return root;
+}
+
+int nodeHeight(Node* node) {
+    return node ? node->height : 0;
+}
+
+// Наивное дерево с высотами в узлах и счетчиком несбалансированных узлов.
+// Вставка меняет высоты только на пути от нового листа к корню, поэтому после
+// каждой вставки ответ "сбалансировано ли дерево" известен за O(глубины).
+struct TrackedBst {
+    Node* root;
+    long long imbalancedNodes;
+    vector<Node*> path;   // путь последней вставки, переиспользуется
+    
+    TrackedBst() : root(nullptr), imbalancedNodes(0) {}
+    
+    ~TrackedBst() {
+        freeTree(root);
     }
     
-    Node* newNode = nullptr;
-    if (value < root->value) {
-        newNode = insertWithCheck(root->left, value);
-        if (!newNode) return nullptr; // Ошибка выделения памяти
-        root->left = newNode;
-    } else {
-        newNode = insertWithCheck(root->right, value);
-        if (!newNode) return nullptr; // Ошибка выделения памяти
-        root->right = newNode;
+    bool insert(int value) {
+        path.clear();
+        Node** link = &root;
+        while (*link) {
+            path.push_back(*link);
+            link = value < (*link)->value ? &(*link)->left : &(*link)->right;
+        }
+        Node* newNode = createNode(value);
+        if (!newNode) return false;
+        *link = newNode;
+        
+        // Поднимаемся к корню: у каждого узла пути выросло не более одного поддерева
+        Node* child = newNode;
+        int oldChildHeight = 0;
+        for (size_t i = path.size(); i-- > 0; ) {
+            Node* node = path[i];
+            int otherHeight = nodeHeight(node->left == child ? node->right : node->left);
+            bool wasImbalanced = abs(oldChildHeight - otherHeight) > 1;
+            bool isImbalanced = abs(child->height - otherHeight) > 1;
+            imbalancedNodes += static_cast<int>(isImbalanced) - static_cast<int>(wasImbalanced);
+            
+            int oldHeight = node->height;
+            node->height = 1 + max(child->height, otherHeight);
+            if (node->height == oldHeight) break;   // выше ничего не меняется
+            oldChildHeight = oldHeight;
+            child = node;
+        }
+        return true;
     }
-    return root;
+    
+    bool isBalanced() const {
+        return imbalancedNodes == 0;
+    }
+};
+
+// Режим со сбалансированным индексом: тот же ответ о наивном дереве за O(n log n)
+int runBalancedMode() {
+    ShadowBst tree;
+    int x;
+    bool inputError = false;
+    
+    cout << "Введите последовательность целых чисел (0 для окончания ввода):" << endl;
+    
+    while (true) {
+        if (!safeInput(x)) {
+            if (cin.eof()) break;
+            cerr << "Ошибка: введено нечисловое значение. Пожалуйста, введите целое число." << endl;
+            inputError = true;
+            continue;
+        }
+        
+        if (x == 0) {
+            break; // Конец ввода
+        }
+        
+        if (!tree.insert(x)) {
+            cerr << "Невозможно выделить память для нового узла." << endl;
+            return 1;
+        }
+    }
+    
+    if (inputError && tree.empty()) {
+        cerr << "Ошибка: не удалось корректно ввести последовательность." << endl;
+        return 1;
+    }
+    
+    cout << (tree.isNaiveBalanced() ? "YES" : "NO") << endl;
+    return 0;
 }
 
-int main() {
+// Потоковый режим: после каждого числа выводится, сбалансировано ли дерево сейчас
+int runStreamMode() {
+    TrackedBst tree;
+    int x;
+    
+    cout << "Введите последовательность целых чисел (0 для окончания ввода):" << endl;
+    
+    while (true) {
+        if (!safeInput(x)) {
+            if (cin.eof()) break;
+            cerr << "Ошибка: введено нечисловое значение. Пожалуйста, введите целое число." << endl;
+            continue;
+        }
+        
+        if (x == 0) {
+            break; // Конец ввода
+        }
+        
+        if (!tree.insert(x)) {
+            cerr << "Невозможно выделить память для нового узла." << endl;
+            return 1;
+        }
+        cout << (tree.isBalanced() ? "YES" : "NO") << '\n';
+    }
+    cout.flush();
+    return 0;
+}
+
+// Режим с узлами в массиве: тот же ответ, что и у дерева на указателях
+int runArenaMode() {
+    ArenaBst tree;
+    int x;
+    bool inputError = false;
+    
+    cout << "Введите последовательность целых чисел (0 для окончания ввода):" << endl;
+    
+    while (true) {
+        if (!safeInput(x)) {
+            if (cin.eof()) break;
+            cerr << "Ошибка: введено нечисловое значение. Пожалуйста, введите целое число." << endl;
+            inputError = true;
+            continue;
+        }
+        
+        if (x == 0) {
+            break; // Конец ввода
+        }
+        
+        if (!tree.insert(x)) {
+            cerr << "Невозможно выделить память для нового узла." << endl;
+            return 1;
+        }
+    }
+    
+    if (inputError && tree.empty()) {
+        cerr << "Ошибка: не удалось корректно ввести последовательность." << endl;
+        return 1;
+    }
+    
+    cout << (tree.isBalanced() ? "YES" : "NO") << endl;
+    return 0;
+}
+
+// Резидентная память процесса в байтах (по /proc/self/statm)
+size_t residentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Сравнение дерева на указателях и дерева в массиве на count случайных ключах
+int runArenaBenchmark(int count) {
+    vector<int> keys(count);
+    mt19937 generator(42);
+    uniform_int_distribution<int> keyDist(1, INT_MAX);
+    for (int& key : keys) {
+        key = keyDist(generator);
+    }
+    cout << "Вставка " << count << " случайных ключей" << endl;
+    
+    {
+        size_t residentBefore = residentBytes();
+        auto start = chrono::steady_clock::now();
+        Node* root = nullptr;
+        for (int key : keys) {
+            root = insertWithCheck(root, key);
+            if (!root) return 1;
+        }
+        auto built = chrono::steady_clock::now();
+        size_t used = residentBytes() - residentBefore;
+        bool balanced = isBalancedOptimized(root);
+        auto checked = chrono::steady_clock::now();
+        freeTree(root);
+        auto freed = chrono::steady_clock::now();
+        cout << "Указатели: " << static_cast<double>(used) / count << " байт/узел, построение "
+             << chrono::duration<double>(built - start).count() << " с, проверка "
+             << chrono::duration<double>(checked - built).count() << " с, освобождение "
+             << chrono::duration<double>(freed - checked).count() << " с, ответ "
+             << (balanced ? "YES" : "NO") << endl;
+    }
+    {
+        auto start = chrono::steady_clock::now();
+        ArenaBst* tree = new ArenaBst;
+        tree->nodes.reserve(count);
+        for (int key : keys) {
+            if (!tree->insert(key)) return 1;
+        }
+        auto built = chrono::steady_clock::now();
+        // Память дерева на указателях уже вернулась в кучу процесса и переиспользуется,
+        // поэтому для массива считается его собственный размер
+        size_t used = tree->nodes.capacity() * sizeof(ArenaNode);
+        bool balanced = tree->isBalanced();
+        auto checked = chrono::steady_clock::now();
+        delete tree;
+        auto freed = chrono::steady_clock::now();
+        cout << "Массив:    " << static_cast<double>(used) / count << " байт/узел, построение "
+             << chrono::duration<double>(built - start).count() << " с, проверка "
+             << chrono::duration<double>(checked - built).count() << " с, освобождение "
+             << chrono::duration<double>(freed - checked).count() << " с, ответ "
+             << (balanced ? "YES" : "NO") << endl;
+    }
+    return 0;
+}
+
+// Поиск значения в дереве на указателях (для сравнения с замороженным деревом)
+bool treeContains(Node* root, int value) {
+    while (root) {
+        if (value == root->value) return true;
+        root = value < root->value ? root->left : root->right;
+    }
+    return false;
+}
+
+// Замороженное дерево для поиска: ключи в порядке Эйтцингера (как в двоичной куче:
+// дети узла k - 2k и 2k+1), то есть верхние уровни дерева лежат в первых кэш-линиях.
+// Поиск без ветвлений: на каждом шаге k = 2k + (ключ < искомого), с упреждающей
+// загрузкой потомков на 4 уровня вперед (16 ключей int = одна кэш-линия).
+struct FrozenBst {
+    vector<int> keys;   // keys[0] не используется
+    size_t size;
+    
+    FrozenBst() : size(0) {}
+    
+    void build(Node* root) {
+        vector<int> sorted;
+        vector<Node*> stack;
+        Node* current = root;
+        while (current || !stack.empty()) {
+            while (current) {
+                stack.push_back(current);
+                current = current->left;
+            }
+            current = stack.back();
+            stack.pop_back();
+            sorted.push_back(current->value);
+            current = current->right;
+        }
+        
+        size = sorted.size();
+        keys.assign(size + 1, 0);
+        size_t next = 0;
+        fill(1, sorted, next);
+    }
+    
+    void fill(size_t k, const vector<int>& sorted, size_t& next) {
+        if (k > size) return;
+        fill(2 * k, sorted, next);
+        keys[k] = sorted[next++];
+        fill(2 * k + 1, sorted, next);
+    }
+    
+    bool contains(int value) const {
+        const int* data = keys.data();
+        size_t k = 1;
+        while (k <= size) {
+            __builtin_prefetch(data + k * 16);
+            k = 2 * k + (data[k] < value);
+        }
+        // Снимаем лишние шаги вправо: остается первый ключ >= value
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+        return k != 0 && data[k] == value;
+    }
+    
+    // Пакетный поиск: BATCH запросов спускаются по дереву одновременно, поэтому
+    // промахи кэша разных запросов перекрываются
+    static const size_t BATCH = 16;
+    
+    void containsBatch(const int* values, size_t count, uint8_t* found) const {
+        const int* data = keys.data();
+        size_t start = 0;
+        for (; start + BATCH <= count; start += BATCH) {
+            size_t k[BATCH];
+            for (size_t j = 0; j < BATCH; j++) k[j] = 1;
+            bool active = size > 0;
+            while (active) {
+                active = false;
+                for (size_t j = 0; j < BATCH; j++) {
+                    if (k[j] <= size) {
+                        __builtin_prefetch(data + k[j] * 16);
+                        k[j] = 2 * k[j] + (data[k[j]] < values[start + j]);
+                        active = true;
+                    }
+                }
+            }
+            for (size_t j = 0; j < BATCH; j++) {
+                size_t index = k[j] >> __builtin_ffsll(static_cast<long long>(~k[j]));
+                found[start + j] = index != 0 && data[index] == values[start + j];
+            }
+        }
+        for (; start < count; start++) {
+            found[start] = contains(values[start]);
+        }
+    }
+};
+
+// Размер блока при пакетном чтении чисел (байт)
+const size_t BULK_BUFFER_SIZE = 1 << 20;
+
+// Пакетное чтение целых чисел из потока: блоками через fread и from_chars вместо cin >>.
+// Числа передаются в onNumber до конца ввода или, если stopAtZero, до 0 (0 в конце
+// последовательности дерева - признак окончания, а в файле запросов - обычный ключ);
+// нечисловые слова пропускаются и подсчитываются в invalidTokens. Слова разбираются
+// так же, как cin >>: допускается знак '+', слово любой длины может пересекать
+// границу блока. Возвращает количество прочитанных чисел.
+template <typename OnNumber>
+long long readNumbersBulk(FILE* input, long long& invalidTokens, bool stopAtZero, OnNumber onNumber) {
+    vector<char> buffer(BULK_BUFFER_SIZE);
+    size_t carried = 0;   // начало слова, разрезанного границей блока
+    long long count = 0;
+    invalidTokens = 0;
+    bool finished = false;
+    
+    while (!finished) {
+        // Перенесенное слово целиком остается перед новым блоком, каким бы длинным оно ни было
+        if (buffer.size() < carried + BULK_BUFFER_SIZE) {
+            buffer.resize(carried + BULK_BUFFER_SIZE);
+        }
+        size_t length = carried + fread(buffer.data() + carried, 1, BULK_BUFFER_SIZE, input);
+        bool lastBlock = length == carried;
+        const char* data = buffer.data();
+        size_t i = 0;
+        carried = 0;
+        
+        while (i < length) {
+            while (i < length && isspace(static_cast<unsigned char>(data[i]))) i++;
+            size_t start = i;
+            while (i < length && !isspace(static_cast<unsigned char>(data[i]))) i++;
+            if (start == i) break;
+            if (i == length && !lastBlock) {
+                // Слово может продолжаться в следующем блоке
+                carried = i - start;
+                if (start > 0) {
+                    copy(buffer.begin() + start, buffer.begin() + i, buffer.begin());
+                }
+                break;
+            }
+            
+            // from_chars не принимает '+', а cin >> принимает (но не "+-")
+            const char* first = data + start;
+            if (*first == '+' && i - start > 1 && first[1] != '-') {
+                first++;
+            }
+            int value;
+            auto result = from_chars(first, data + i, value);
+            if (result.ec != errc() || result.ptr != data + i) {
+                invalidTokens++;
+                continue;
+            }
+            if (value == 0 && stopAtZero) {
+                finished = true;
+                break;
+            }
+            count++;
+            if (!onNumber(value)) {
+                return -1;
+            }
+        }
+        if (lastBlock) break;
+    }
+    return count;
+}
+
+// Проверка пакетного чтения против cin >>: особые слова (длинные, со знаками,
+// переполнение, мусор) стоят поперек границ блоков, вокруг - случайные числа
+int runBulkCheck() {
+    const vector<string> special = {
+        "123456789", "+2147483647", "-2147483648", string(300, '0') + "42",
+        "+" + string(BULK_BUFFER_SIZE + 100, '0') + "7", "+-5", "2147483648", "12a", "-0", "+"
+    };
+    mt19937 generator(5);
+    string text;
+    for (size_t b = 0; b < special.size(); b++) {
+        size_t middle = (b + 1) * 2 * BULK_BUFFER_SIZE;   // граница блока посреди особого слова
+        size_t start = middle - min(special[b].size() / 2, middle);
+        while (text.size() + 8 < start) {
+            text += to_string(static_cast<int>(generator() % 2000000) - 1000000) + (generator() % 8 ? " " : "\n");
+        }
+        text.append(start - text.size(), ' ');
+        text += special[b] + " ";
+    }
+    
+    // Ожидаемый результат: каждое слово отдельно через istringstream >> int
+    vector<int> expected;
+    long long expectedInvalid = 0;
+    istringstream words(text);
+    string word;
+    while (words >> word) {
+        istringstream token(word);
+        int value;
+        if (token >> value && token.peek() == EOF) {
+            expected.push_back(value);
+        } else {
+            expectedInvalid++;
+        }
+    }
+    
+    FILE* input = tmpfile();
+    if (!input) {
+        cerr << "Ошибка: не удалось создать временный файл" << endl;
+        return 1;
+    }
+    fwrite(text.data(), 1, text.size(), input);
+    rewind(input);
+    vector<int> actual;
+    long long invalidTokens = 0;
+    readNumbersBulk(input, invalidTokens, false, [&](int value) {
+        actual.push_back(value);
+        return true;
+    });
+    fclose(input);
+    
+    bool passed = actual == expected && invalidTokens == expectedInvalid;
+    cout << "Байт: " << text.size() << ", чисел: " << actual.size() << " (ожидалось " << expected.size()
+         << "), нечисловых слов: " << invalidTokens << " (ожидалось " << expectedInvalid << ")" << endl;
+    cout << (passed ? "Проверка пройдена" : "Проверка не пройдена") << endl;
+    return passed ? 0 : 1;
+}
+
+// Параллельная проверка: верхние уровни дерева обходятся в ширину, пока на уровне не
+// наберется достаточно поддеревьев, затем поддеревья проверяются checkBalanced на
+// threadCount потоках. Первый найденный дисбаланс отменяет остальные задачи.
+bool isBalancedParallel(Node* root, int threadCount) {
+    if (!root) return true;
+    
+    vector<Node*> level(1, root);
+    int depth = 0;
+    const size_t targetTasks = static_cast<size_t>(threadCount) * 4;
+    while (level.size() < targetTasks && depth < 24) {
+        vector<Node*> next;
+        for (Node* node : level) {
+            if (node->left) next.push_back(node->left);
+            if (node->right) next.push_back(node->right);
+        }
+        if (next.empty()) break;
+        level.swap(next);
+        depth++;
+    }
+    
+    atomic<bool> cancelled(false);
+    atomic<size_t> nextTask(0);
+    vector<int> heights(level.size(), 0);
+    vector<thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            size_t task;
+            while (!cancelled.load(memory_order_relaxed) && (task = nextTask.fetch_add(1)) < level.size()) {
+                bool balanced = true;
+                heights[task] = checkBalanced(level[task], balanced, &cancelled);
+                if (!balanced) {
+                    cancelled.store(true);
+                }
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    if (cancelled.load()) return false;
+    
+    // Высоты верхних уровней по готовым высотам поддеревьев (глубина не больше 24)
+    unordered_map<Node*, int> frontier;
+    for (size_t i = 0; i < level.size(); i++) {
+        frontier[level[i]] = heights[i];
+    }
+    bool balanced = true;
+    struct Combine {
+        const unordered_map<Node*, int>& frontier;
+        int frontierDepth;
+        bool& balanced;
+        int height(Node* node, int depth) {
+            if (!node) return 0;
+            if (depth == frontierDepth) return frontier.at(node);
+            int leftHeight = height(node->left, depth + 1);
+            int rightHeight = height(node->right, depth + 1);
+            if (abs(leftHeight - rightHeight) > 1) balanced = false;
+            return 1 + max(leftHeight, rightHeight);
+        }
+    };
+    Combine combine{frontier, depth, balanced};
+    combine.height(root, 0);
+    return balanced;
+}
+
+// Пакетные запросы принадлежности к замороженному дереву: числа из файла,
+// на каждое выводится YES или NO
+int answerQueries(Node* root, const string& queriesFile) {
+    FILE* input = fopen(queriesFile.c_str(), "rb");
+    if (!input) {
+        cerr << "Ошибка: Не удалось открыть файл " << queriesFile << " для чтения" << endl;
+        return 1;
+    }
+    vector<int> queries;
+    long long invalidTokens = 0;
+    readNumbersBulk(input, invalidTokens, false, [&](int value) {
+        queries.push_back(value);
+        return true;
+    });
+    fclose(input);
+    if (invalidTokens > 0) {
+        cerr << "Ошибка: пропущено нечисловых запросов: " << invalidTokens << endl;
+    }
+    
+    auto start = chrono::steady_clock::now();
+    FrozenBst frozen;
+    frozen.build(root);
+    auto frozenAt = chrono::steady_clock::now();
+    vector<uint8_t> found(queries.size());
+    frozen.containsBatch(queries.data(), queries.size(), found.data());
+    auto answered = chrono::steady_clock::now();
+    
+    string output;
+    output.reserve(queries.size() * 4);
+    for (uint8_t hit : found) {
+        output += hit ? "YES\n" : "NO\n";
+    }
+    fwrite(output.data(), 1, output.size(), stdout);
+    double querySeconds = chrono::duration<double>(answered - frozenAt).count();
+    cerr << "Запросов: " << queries.size() << ", заморозка: " << chrono::duration<double>(frozenAt - start).count()
+         << " с, поиск: " << (querySeconds > 0 ? queries.size() / querySeconds : 0) << " запросов/с" << endl;
+    return 0;
+}
+
+// Пакетный режим: числа из файла или stdin, параллельная проверка сбалансированности
+int runBulkMode(const string& filename, const string& queriesFile, int threadCount) {
+    FILE* input = stdin;
+    if (!filename.empty()) {
+        input = fopen(filename.c_str(), "rb");
+        if (!input) {
+            cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+            return 1;
+        }
+    }
+    
+    auto start = chrono::steady_clock::now();
+    Node* root = nullptr;
+    long long invalidTokens = 0;
+    long long count = readNumbersBulk(input, invalidTokens, true, [&](int value) {
+        Node* newRoot = insertWithCheck(root, value);
+        if (!newRoot) return false;
+        root = newRoot;
+        return true;
+    });
+    if (input != stdin) fclose(input);
+    if (count < 0) {
+        cerr << "Невозможно выделить память для нового узла." << endl;
+        freeTree(root);
+        return 1;
+    }
+    if (invalidTokens > 0) {
+        cerr << "Ошибка: пропущено нечисловых значений: " << invalidTokens << endl;
+    }
+    if (invalidTokens > 0 && !root) {
+        cerr << "Ошибка: не удалось корректно ввести последовательность." << endl;
+        return 1;
+    }
+    auto built = chrono::steady_clock::now();
+    
+    bool balanced = isBalancedParallel(root, threadCount);
+    auto checked = chrono::steady_clock::now();
+    cout << (balanced ? "YES" : "NO") << endl;
+    cerr << "Чисел: " << count << ", чтение и построение: " << chrono::duration<double>(built - start).count()
+         << " с, проверка (" << threadCount << " потоков): "
+         << chrono::duration<double>(checked - built).count() << " с" << endl;
+    
+    int result = 0;
+    if (!queriesFile.empty()) {
+        result = answerQueries(root, queriesFile);
+    }
+    freeTree(root);
+    return result;
+}
+
+// Сравнение поиска по указателям и по замороженному дереву на count случайных ключах
+int runFreezeBenchmark(int count) {
+    mt19937 generator(7);
+    uniform_int_distribution<int> keyDist(1, INT_MAX);
+    Node* root = nullptr;
+    vector<int> inserted(count);
+    for (int& key : inserted) {
+        key = keyDist(generator);
+        root = insertWithCheck(root, key);
+        if (!root) return 1;
+    }
+    // Половина запросов - существующие ключи, половина - случайные
+    const size_t queryCount = 10000000;
+    vector<int> queries(queryCount);
+    uniform_int_distribution<int> pick(0, count - 1);
+    for (size_t i = 0; i < queryCount; i++) {
+        queries[i] = i % 2 == 0 ? inserted[pick(generator)] : keyDist(generator);
+    }
+    
+    FrozenBst frozen;
+    auto start = chrono::steady_clock::now();
+    frozen.build(root);
+    double freezeSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Ключей: " << count << " (" << count * sizeof(int) / (1024 * 1024) << " МБ в замороженном виде), "
+         << "заморозка: " << freezeSeconds << " с" << endl;
+    
+    long long hits[3] = {0, 0, 0};
+    double seconds[3];
+    
+    start = chrono::steady_clock::now();
+    for (int query : queries) hits[0] += treeContains(root, query);
+    seconds[0] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    start = chrono::steady_clock::now();
+    for (int query : queries) hits[1] += frozen.contains(query);
+    seconds[1] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    vector<uint8_t> found(queryCount);
+    start = chrono::steady_clock::now();
+    frozen.containsBatch(queries.data(), queryCount, found.data());
+    seconds[2] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (uint8_t hit : found) hits[2] += hit;
+    
+    const char* names[3] = {"Указатели", "Эйтцингер", "Эйтцингер, пакетами"};
+    for (int i = 0; i < 3; i++) {
+        cout << names[i] << ": " << queryCount / seconds[i] << " запросов/с (найдено " << hits[i] << ")" << endl;
+    }
+    freeTree(root);
+    return hits[0] == hits[1] && hits[1] == hits[2] ? 0 : 1;
+}
+
+// Высота АВЛ-дерева с проверкой сохраненных высот, баланса и порядка ключей;
+// при нарушении valid сбрасывается. Глубина рекурсии - O(log n).
+int avlVerify(AvlNode* node, bool& valid) {
+    if (!node) return 0;
+    int leftHeight = avlVerify(node->left, valid);
+    int rightHeight = avlVerify(node->right, valid);
+    if (abs(leftHeight - rightHeight) > 1 || node->height != 1 + max(leftHeight, rightHeight) ||
+        (node->left && node->left->value > node->value) ||
+        (node->right && node->right->value < node->value)) {
+        valid = false;
+    }
+    return 1 + max(leftHeight, rightHeight);
+}
+
+// Проверка на отсортированном вводе из count ключей (по возрастанию и по убыванию):
+// индекс --avl должен остаться АВЛ-деревом высотой не больше 1.44 log2(n + 2),
+// наивное дерево - цепочкой высотой count, а проверка баланса и освобождение
+// наивного дерева такой глубины - пройти без переполнения стека
+int runSortedCheck(int count) {
+    bool passed = true;
+    double heightLimit = 1.4405 * log2(static_cast<double>(count) + 2.0);
+    for (int descending = 0; descending <= 1; descending++) {
+        const char* order = descending ? "по убыванию" : "по возрастанию";
+        
+        auto start = chrono::steady_clock::now();
+        ShadowBst* tree = new ShadowBst;
+        for (int i = 1; i <= count; i++) {
+            if (!tree->insert(descending ? count - i + 1 : i)) return 1;
+        }
+        bool valid = true;
+        int indexHeight = avlVerify(tree->index, valid);
+        int naiveHeight = tree->naiveDepth.back() + 1;
+        bool naiveBalanced = tree->isNaiveBalanced();
+        delete tree;
+        double shadowSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        
+        // Наивное дерево отсортированного ввода - цепочка, поэтому строится
+        // присоединением к последнему узлу (insert дал бы то же дерево за O(n^2))
+        start = chrono::steady_clock::now();
+        Node* root = nullptr;
+        Node* last = nullptr;
+        for (int i = 1; i <= count; i++) {
+            Node* node = createNode(descending ? count - i + 1 : i);
+            if (!node) return 1;
+            if (!last) {
+                root = node;
+            } else if (descending) {
+                last->left = node;
+            } else {
+                last->right = node;
+            }
+            last = node;
+        }
+        bool chainBalanced = isBalancedOptimized(root);
+        freeTree(root);
+        double chainSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        
+        bool expectedBalanced = count <= 2;
+        cout << "Ключи " << order << ": высота индекса " << indexHeight << " (предел "
+             << static_cast<int>(heightLimit) << "), высота наивного дерева " << naiveHeight
+             << ", ответ " << (naiveBalanced ? "YES" : "NO") << " за " << shadowSeconds
+             << " с; цепочка: проверка и освобождение за " << chainSeconds << " с" << endl;
+        if (!valid || indexHeight > heightLimit) {
+            cerr << "Ошибка: индекс ключей " << order << " не является АВЛ-деревом нужной высоты" << endl;
+            passed = false;
+        }
+        if (naiveHeight != count || naiveBalanced != expectedBalanced || chainBalanced != expectedBalanced) {
+            cerr << "Ошибка: неверная форма или ответ для наивного дерева ключей " << order << endl;
+            passed = false;
+        }
+    }
+    cout << (passed ? "Проверка пройдена" : "Проверка не пройдена") << endl;
+    return passed ? 0 : 1;
+}
+
+void printUsage(const string& programName) {
+    cerr << "Использование: " << programName << " [--avl | --stream | --arena | --bench-arena <число ключей>]" << endl;
+    cerr << "       " << programName << " --bulk [--file <файл>] [--threads <число>] [--queries <файл>]" << endl;
+    cerr << "       " << programName << " --bench-freeze <число ключей>" << endl;
+    cerr << "       " << programName << " --check-sorted <число ключей> | --check-bulk" << endl;
+    cerr << "  --avl          строить сбалансированный индекс вместо наивного дерева" << endl;
+    cerr << "  --stream       выводить ответ после каждого числа" << endl;
+    cerr << "  --arena        хранить узлы в массиве с 32-битными индексами" << endl;
+    cerr << "  --bench-arena  сравнить память и время дерева на указателях и в массиве" << endl;
+    cerr << "  --bulk         быстрое чтение чисел из файла или stdin и параллельная проверка" << endl;
+    cerr << "  --queries      после проверки заморозить дерево и ответить на запросы из файла" << endl;
+    cerr << "  --bench-freeze сравнить поиск по указателям и по замороженному дереву" << endl;
+    cerr << "  --check-sorted вставить отсортированные ключи и проверить высоты и ответ (например, 10000000)" << endl;
+    cerr << "  --check-bulk   сравнить пакетное чтение чисел с cin >> на словах поперек границ блоков" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string mode, filename, queriesFile;
+    int benchCount = 0;
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--avl" || arg == "--stream" || arg == "--arena" || arg == "--bulk" || arg == "--check-bulk") {
+            mode = arg;
+        } else if ((arg == "--bench-arena" || arg == "--bench-freeze" || arg == "--check-sorted") && i + 1 < argc) {
+            mode = arg;
+            benchCount = atoi(argv[++i]);
+        } else if (arg == "--file" && i + 1 < argc) {
+            filename = argv[++i];
+        } else if (arg == "--queries" && i + 1 < argc) {
+            queriesFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        } else {
+            cerr << "Ошибка: неизвестный аргумент: " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (threadCount <= 0) {
+        cerr << "Ошибка: число потоков должно быть положительным" << endl;
+        return 1;
+    }
+    if (mode == "--avl") {
+        return runBalancedMode();
+    }
+    if (mode == "--stream") {
+        return runStreamMode();
+    }
+    if (mode == "--arena") {
+        return runArenaMode();
+    }
+    if (mode == "--check-bulk") {
+        return runBulkCheck();
+    }
+    if (mode == "--bench-arena" || mode == "--bench-freeze" || mode == "--check-sorted") {
+        if (benchCount <= 0) {
+            cerr << "Ошибка: число ключей должно быть положительным" << endl;
+            return 1;
+        }
+        if (mode == "--check-sorted") {
+            return runSortedCheck(benchCount);
+        }
+        return mode == "--bench-arena" ? runArenaBenchmark(benchCount) : runFreezeBenchmark(benchCount);
+    }
+    if (mode == "--bulk" || !filename.empty() || !queriesFile.empty()) {
+        return runBulkMode(filename, queriesFile, threadCount);
+    }
+    
     Node* root = nullptr;
     int x;
     bool inputError = false;
@@ -1,6 +1,26 @@
 #include <iostream>
 #include <chrono>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <malloc.h>
+#include <cmath>
+#include <unordered_map>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <numeric>
 #include "structures_from_lr1.h"  // Наши структуры
 
 using namespace std;
@@ -15,6 +35,26 @@ struct HashItem {
     HashItem(int k, const string& v) : key(k), value(v), isDeleted(false) {}
 };
 
+// Сколько ячеек (корзин) старой таблицы переносится за одну операцию
+// при постепенной реструктуризации
+const int REHASH_MIGRATE_STEP = 16;
+
+// Доля удаленных ячеек от емкости, при которой таблица с открытой адресацией
+// перестраивается в том же размере
+const double TOMBSTONE_COMPACT_THRESHOLD = 0.25;
+
+// Перемешивание ключа (финализатор MurmurHash3): соседние и кратные степени
+// двойки ключи расходятся по всем битам результата
+inline uint64_t mixKey(int key) {
+    uint64_t h = static_cast<uint32_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
 // Хеш-таблица с открытой адресацией (используем SetArray как динамический массив)
 struct OpenAddressingHashTable {
     SetArray* table;  // Используем нашу структуру вместо std::vector
@@ -22,10 +62,26 @@ struct OpenAddressingHashTable {
     int size;
     double loadFactorThreshold;
     int rehashCount;
+    bool verbose;            // Сообщать о каждой операции (в бенчмарках выключено)
+    bool incrementalRehash;  // Переносить элементы понемногу, а не все сразу
+    SetArray* oldTable;      // Таблица, из которой идет перенос (nullptr, если переноса нет)
+    int oldCapacity;
+    int migratePosition;     // Первая еще не перенесенная ячейка старой таблицы
+    int deletedCount;        // Удаленные ячейки ("DELETED") в текущей таблице
+    bool countTombstones;    // Учитывать удаленные ячейки в загрузке и очищать их
+    int compactionCount;
+    long long probeCount;    // Просмотренные ячейки при поиске (для статистики)
+    bool powerOfTwo;         // Емкость - степень двойки: индекс по маске от перемешанного ключа
 
-    OpenAddressingHashTable(int initialCapacity = 8, double threshold = 0.9) 
-        : capacity(initialCapacity), size(0), loadFactorThreshold(threshold), rehashCount(0) {
-        table = createSet(initialCapacity);
+    OpenAddressingHashTable(int initialCapacity = 8, double threshold = 0.9, bool powerOfTwoMode = false) 
+        : capacity(initialCapacity), size(0), loadFactorThreshold(threshold), rehashCount(0),
+          verbose(true), incrementalRehash(false), oldTable(nullptr), oldCapacity(0), migratePosition(0),
+          deletedCount(0), countTombstones(true), compactionCount(0), probeCount(0), powerOfTwo(powerOfTwoMode) {
+        if (powerOfTwo) {
+            capacity = 8;
+            while (capacity < initialCapacity) capacity *= 2;
+        }
+        table = createSet(capacity);
         // Инициализируем массив пустыми элементами
         for (int i = 0; i < capacity; i++) {
             table->data[i] = "";  // Пустая строка как маркер пустой ячейки
@@ -34,37 +90,136 @@ struct OpenAddressingHashTable {
     
     ~OpenAddressingHashTable() {
         destroySet(table);
+        if (oldTable != nullptr) {
+            destroySet(oldTable);
+        }
     }
 
     // Основная хеш-функция
     int hash1(int key) {
-        return key % capacity;
+        return hash1(key, capacity);
+    }
+
+    int hash1(int key, int tableCapacity) {
+        if (powerOfTwo) {
+            return static_cast<int>(mixKey(key) & (tableCapacity - 1));
+        }
+        // Остаток от деления отрицательного ключа отрицателен
+        return (key % tableCapacity + tableCapacity) % tableCapacity;
     }
 
     // Вторая хеш-функция для двойного хеширования
     int hash2(int key) {
-        return 1 + (key % (capacity - 1));
+        return hash2(key, capacity);
+    }
+
+    // Шаг взаимно прост с емкостью, поэтому последовательность проб обходит всю
+    // таблицу и не находит места, только если свободных ячеек нет совсем. В режиме
+    // степени двойки для этого достаточно нечетного шага, иначе шаг увеличивается
+    // до взаимно простого (gcd(capacity - 1, capacity) = 1, так что шаг < емкости)
+    int hash2(int key, int tableCapacity) {
+        if (powerOfTwo) {
+            return static_cast<int>((mixKey(key) >> 32) & (tableCapacity - 1)) | 1;
+        }
+        int step = 1 + (key % (tableCapacity - 1) + tableCapacity - 1) % (tableCapacity - 1);
+        while (gcd(step, tableCapacity) != 1) {
+            step++;
+        }
+        return step;
+    }
+
+    // Следующая ячейка последовательности проб
+    int nextIndex(int index, int step, int tableCapacity) {
+        return powerOfTwo ? (index + step) & (tableCapacity - 1) : (index + step) % tableCapacity;
+    }
+
+    // Ключ из ячейки "ключ:значение"; false для пустой и удаленной ячейки
+    bool cellKey(const string& cellValue, int& key) {
+        if (cellValue.empty() || cellValue == "DELETED") {
+            return false;
+        }
+        size_t colonPos = cellValue.find(':');
+        if (colonPos == string::npos) {
+            return false;
+        }
+        key = stoi(cellValue.substr(0, colonPos));
+        return true;
+    }
+
+    // Позиция ключа в таблице емкости tableCapacity или -1
+    int findIndex(SetArray* source, int tableCapacity, int key) {
+        int index = hash1(key, tableCapacity);
+        int step = hash2(key, tableCapacity);
+        for (int i = 0; i < tableCapacity; i++) {
+            probeCount++;
+            const string& cellValue = source->data[index];
+            if (cellValue.empty()) {
+                return -1;
+            }
+            int existingKey;
+            if (cellKey(cellValue, existingKey) && existingKey == key) {
+                return index;
+            }
+            index = nextIndex(index, step, tableCapacity);
+        }
+        return -1;
+    }
+
+    // Свободная ячейка для ключа в текущей таблице (без проверки дубликатов и без
+    // вывода); занимаемая удаленная ячейка сразу вычитается из deletedCount.
+    // -1, если последовательность проб ключа не нашла свободного места
+    int freeCell(int key) {
+        int index = hash1(key);
+        int step = hash2(key);
+        for (int i = 0; i < capacity; i++) {
+            const string& current = table->data[index];
+            if (current.empty() || current == "DELETED") {
+                if (!current.empty()) {
+                    deletedCount--;
+                }
+                return index;
+            }
+            index = nextIndex(index, step, capacity);
+        }
+        return -1;
     }
 
     // Вставка элемента
     void insert(int key, const string& value) {
-        if (getLoadFactor() >= loadFactorThreshold) {
-            rehash();
+        if (oldTable != nullptr) {
+            migrateStep();
+        }
+        compactIfNeeded();
+        if (getOccupiedFactor() >= loadFactorThreshold) {
+            grow();
+        }
+        if (oldTable != nullptr) {
+            // Ключ еще не перенесен: забираем его из старой таблицы вместе с новым значением
+            int oldIndex = findIndex(oldTable, oldCapacity, key);
+            if (oldIndex >= 0) {
+                oldTable->data[oldIndex] = "DELETED";
+                size--;
+            }
         }
 
         int index = hash1(key);
         int step = hash2(key);
+        int firstDeleted = -1;
         int i = 0;
 
+        // Ключ может стоять дальше удаленных ячеек, поэтому пробы идут до пустой ячейки
         while (i < capacity) {
-            // Проверяем пустую ячейку (ключ -1 или удалена)
-            string cellValue = table->data[index];
-            if (cellValue.empty() || cellValue == "DELETED") {
-                // Сохраняем в формате "ключ:значение"
-                table->data[index] = to_string(key) + ":" + value;
-                size++;
-                cout << "Ключ " << key << " вставлен в позицию " << index << endl;
-                return;
+            const string& cellValue = table->data[index];
+            if (cellValue.empty()) {
+                break;
+            }
+            if (cellValue == "DELETED") {
+                if (firstDeleted < 0) {
+                    firstDeleted = index;
+                }
+                index = nextIndex(index, step, capacity);
+                i++;
+                continue;
             }
             
             // Извлекаем ключ из строки
@@ -74,79 +229,76 @@ struct OpenAddressingHashTable {
                 if (existingKey == key) {
                     // Обновляем значение
                     table->data[index] = to_string(key) + ":" + value;
-                    cout << "Ключ " << key << " обновлен в позиции " << index << endl;
+                    if (verbose) {
+                        cout << "Ключ " << key << " обновлен в позиции " << index << endl;
+                    }
                     return;
                 }
             }
             
-            index = (index + step) % capacity;
+            index = nextIndex(index, step, capacity);
             i++;
         }
         
-        rehash();
-        insert(key, value);
+        // Ключа нет: первая удаленная ячейка на пути проб занимается вместо пустой
+        if (firstDeleted >= 0) {
+            index = firstDeleted;
+            deletedCount--;
+        } else if (i == capacity) {
+            // Пробы обошли всю таблицу, свободных ячеек нет (только при пороге загрузки >= 1)
+            grow();
+            insert(key, value);
+            return;
+        }
+        // Сохраняем в формате "ключ:значение"
+        table->data[index] = to_string(key) + ":" + value;
+        size++;
+        if (verbose) {
+            cout << "Ключ " << key << " вставлен в позицию " << index << endl;
+        }
     }
 
     // Поиск элемента
     string search(int key) {
-        int index = hash1(key);
-        int step = hash2(key);
-        int i = 0;
-
-        while (i < capacity) {
-            string cellValue = table->data[index];
-            
-            if (cellValue.empty()) {
-                return "Not Found";
-            }
-            
-            if (cellValue != "DELETED") {
-                size_t colonPos = cellValue.find(':');
-                if (colonPos != string::npos) {
-                    int existingKey = stoi(cellValue.substr(0, colonPos));
-                    if (existingKey == key) {
-                        return cellValue.substr(colonPos + 1);
-                    }
-                }
-            }
-            
-            index = (index + step) % capacity;
-            i++;
+        SetArray* source = table;
+        int index = findIndex(table, capacity, key);
+        if (index < 0 && oldTable != nullptr) {
+            source = oldTable;
+            index = findIndex(oldTable, oldCapacity, key);
         }
-        return "Not Found";
+        if (index < 0) {
+            return "Not Found";
+        }
+        const string& cellValue = source->data[index];
+        return cellValue.substr(cellValue.find(':') + 1);
     }
 
     // Удаление элемента
     void remove(int key) {
-        int index = hash1(key);
-        int step = hash2(key);
-        int i = 0;
-
-        while (i < capacity) {
-            string cellValue = table->data[index];
-            
-            if (cellValue.empty()) {
+        if (oldTable != nullptr) {
+            migrateStep();
+        }
+        SetArray* source = table;
+        int index = findIndex(table, capacity, key);
+        if (index < 0 && oldTable != nullptr) {
+            source = oldTable;
+            index = findIndex(oldTable, oldCapacity, key);
+        }
+        if (index < 0) {
+            if (verbose) {
                 cout << "Ключ " << key << " не найден для удаления" << endl;
-                return;
-            }
-            
-            if (cellValue != "DELETED") {
-                size_t colonPos = cellValue.find(':');
-                if (colonPos != string::npos) {
-                    int existingKey = stoi(cellValue.substr(0, colonPos));
-                    if (existingKey == key) {
-                        table->data[index] = "DELETED";
-                        size--;
-                        cout << "Ключ " << key << " удален из позиции " << index << endl;
-                        return;
-                    }
-                }
             }
-            
-            index = (index + step) % capacity;
-            i++;
+            return;
+        }
+        source->data[index] = "DELETED";
+        size--;
+        if (source == table) {
+            deletedCount++;
         }
-        cout << "Ключ " << key << " не найден для удаления" << endl;
+        if (verbose) {
+            cout << "Ключ " << key << " удален из позиции " << index << endl;
+        }
+        compactIfNeeded();
     }
 
     // Получение коэффициента загрузки
@@ -154,42 +306,178 @@ struct OpenAddressingHashTable {
         return static_cast<double>(size) / capacity;
     }
 
-    // Реструктуризация таблицы
-    void rehash() {
+    // Доля занятых ячеек вместе с удаленными: именно она определяет длину проб
+    double getOccupiedFactor() {
+        int occupied = countTombstones ? size + deletedCount : size;
+        return static_cast<double>(occupied) / capacity;
+    }
+
+    // Перестройка в том же размере, если удаленных ячеек стало слишком много.
+    // При постепенной реструктуризации очистка идет тем же переносом по
+    // REHASH_MIGRATE_STEP ячеек, иначе вставка или удаление ждали бы всю таблицу
+    void compactIfNeeded() {
+        if (!countTombstones || deletedCount <= capacity * TOMBSTONE_COMPACT_THRESHOLD) {
+            return;
+        }
+        compactionCount++;
+        if (verbose) {
+            cout << "\nОчистка удаленных ячеек: " << deletedCount << " из " << capacity << endl;
+        }
+        if (incrementalRehash) {
+            startRehash(capacity);
+        } else {
+            rebuild(capacity);
+        }
+    }
+
+    // Рост таблицы: постепенный или сразу, в зависимости от режима
+    void grow() {
+        if (incrementalRehash) {
+            startGrowth();
+        } else {
+            rehash();
+        }
+    }
+
+    // Начало постепенного роста вдвое
+    void startGrowth() {
         rehashCount++;
-        cout << "\nРеструктуризация таблицы с открытой адресацией" << endl;
-        cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
-        cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        if (verbose) {
+            cout << "\nПостепенная реструктуризация таблицы с открытой адресацией" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        }
+        startRehash(capacity * 2);
+    }
 
-        // Сохраняем старые данные
-        SetArray* oldTable = table;
-        int oldCapacity = capacity;
-        
-        // Создаем новую таблицу
-        capacity *= 2;
+    // Начало постепенной реструктуризации в таблицу емкости newCapacity (вдвое
+    // больше при росте, той же при очистке удаленных ячеек); старая таблица
+    // переносится по REHASH_MIGRATE_STEP ячеек за insert/remove
+    void startRehash(int newCapacity) {
+        SetArray* previous = oldTable;
+        int previousCapacity = oldCapacity;
+        int previousPosition = migratePosition;
+        oldTable = table;
+        oldCapacity = capacity;
+        migratePosition = 0;
+        deletedCount = 0;
+        capacity = newCapacity;
+        // Строки массива уже пустые; повторное заполнение удвоило бы паузу на старте
         table = createSet(capacity);
-        size = 0;
         
-        // Инициализируем новую таблицу
-        for (int i = 0; i < capacity; i++) {
-            table->data[i] = "";
+        if (previous != nullptr) {
+            // Предыдущий перенос не закончен: его остаток сразу уходит в новую таблицу.
+            // Емкость не уменьшается, а новая таблица пока пуста, так что место есть всегда
+            for (int i = previousPosition; i < previousCapacity; i++) {
+                int key;
+                if (cellKey(previous->data[i], key)) {
+                    table->data[freeCell(key)] = move(previous->data[i]);
+                }
+            }
+            destroySet(previous);
         }
+    }
 
-        // Переносим данные из старой таблицы
-        for (int i = 0; i < oldCapacity; i++) {
-            string cellValue = oldTable->data[i];
-            if (!cellValue.empty() && cellValue != "DELETED") {
-                size_t colonPos = cellValue.find(':');
-                if (colonPos != string::npos) {
-                    int key = stoi(cellValue.substr(0, colonPos));
-                    string value = cellValue.substr(colonPos + 1);
-                    insert(key, value);
+    // Перенос очередной порции ячеек из старой таблицы. Строки переносятся без
+    // копирования: в старой таблице остаются короткие "DELETED" без своих буферов,
+    // поэтому освобождение старой таблицы в конце переноса - это один delete[] без
+    // возврата в кучу буфера каждой ячейки
+    void migrateStep() {
+        int end = min(migratePosition + REHASH_MIGRATE_STEP, oldCapacity);
+        for (; migratePosition < end; migratePosition++) {
+            string& cellValue = oldTable->data[migratePosition];
+            int key;
+            if (!cellKey(cellValue, key)) {
+                continue;
+            }
+            int index = freeCell(key);
+            if (index < 0) {
+                // Новой таблицы не хватило: начинаем следующую реструктуризацию,
+                // остаток этой переносится в нее сразу
+                startGrowth();
+                return;
+            }
+            table->data[index] = move(cellValue);
+            // Перенесенная ячейка становится удаленной, чтобы не обрывать пробы в старой таблице
+            cellValue = "DELETED";
+        }
+        if (migratePosition == oldCapacity) {
+            destroySet(oldTable);
+            oldTable = nullptr;
+            if (verbose) {
+                cout << "Реструктуризация завершена!" << endl;
+            }
+        }
+    }
+
+    // Перестройка всех элементов (включая недоперенесенные) в таблицу емкости
+    // newCapacity; если пробы какого-то ключа не находят места, емкость удваивается
+    void rebuild(int newCapacity) {
+        SetArray* sources[2] = {table, oldTable};
+        int sourceCapacities[2] = {capacity, oldCapacity};
+        while (true) {
+            table = createSet(newCapacity);
+            capacity = newCapacity;
+            for (int i = 0; i < capacity; i++) {
+                table->data[i] = "";
+            }
+            bool placed = true;
+            for (int s = 0; s < 2 && placed; s++) {
+                if (sources[s] == nullptr) continue;
+                for (int i = 0; i < sourceCapacities[s] && placed; i++) {
+                    int key;
+                    if (cellKey(sources[s]->data[i], key)) {
+                        int index = freeCell(key);
+                        placed = index >= 0;
+                        if (placed) {
+                            table->data[index] = sources[s]->data[i];
+                        }
+                    }
                 }
             }
+            if (placed) break;
+            destroySet(table);
+            newCapacity *= 2;
+        }
+        deletedCount = 0;
+        for (SetArray* source : sources) {
+            if (source != nullptr) {
+                destroySet(source);
+            }
+        }
+        oldTable = nullptr;
+    }
+
+    // Реструктуризация таблицы
+    void rehash() {
+        rehashCount++;
+        if (verbose) {
+            cout << "\nРеструктуризация таблицы с открытой адресацией" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
         }
+
+        // Элементы переносятся напрямую, без повторных insert и их вывода
+        rebuild(capacity * 2);
         
-        destroySet(oldTable);
-        cout << "Реструктуризация завершена!" << endl;
+        if (verbose) {
+            cout << "Реструктуризация завершена!" << endl;
+        }
+    }
+
+    // Обход всех элементов (включая еще не перенесенные)
+    template <typename Visit>
+    void forEach(Visit visit) {
+        for (SetArray* source : {table, oldTable}) {
+            int sourceCapacity = source == table ? capacity : oldCapacity;
+            for (int i = 0; source != nullptr && i < sourceCapacity; i++) {
+                const string& cellValue = source->data[i];
+                int key;
+                if (cellKey(cellValue, key)) {
+                    visit(key, cellValue.substr(cellValue.find(':') + 1));
+                }
+            }
+        }
     }
 
     // Вывод всех элементов
@@ -207,6 +495,15 @@ struct OpenAddressingHashTable {
                 }
             }
         }
+        for (int i = 0; oldTable != nullptr && i < oldCapacity; i++) {
+            const string& cellValue = oldTable->data[i];
+            int key;
+            if (cellKey(cellValue, key)) {
+                cout << "  Старая таблица, индекс " << i << ": ключ=" << key
+                     << ", значение='" << cellValue.substr(cellValue.find(':') + 1) << "'" << endl;
+                isEmpty = false;
+            }
+        }
         if (isEmpty) {
             cout << "  Таблица пуста" << endl;
         }
@@ -214,17 +511,17 @@ struct OpenAddressingHashTable {
 
     // Вывод статистики
     void printStats() {
-        int deletedCount = 0;
-        for (int i = 0; i < capacity; i++) {
-            if (table->data[i] == "DELETED") deletedCount++;
-        }
-        
         cout << "\nСтатистика открытой адресации" << endl;
         cout << "Размер: " << size << endl;
         cout << "Емкость: " << capacity << endl;
         cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
         cout << "Удаленных элементов: " << deletedCount << endl;
         cout << "Количество реструктуризаций: " << rehashCount << endl;
+        cout << "Очисток удаленных ячеек: " << compactionCount << endl;
+        cout << "Индексация: " << (powerOfTwo ? "маска от перемешанного ключа" : "остаток от деления") << endl;
+        if (oldTable != nullptr) {
+            cout << "Перенесено ячеек старой таблицы: " << migratePosition << " из " << oldCapacity << endl;
+        }
     }
 };
 
@@ -244,9 +541,15 @@ struct ChainingHashTable {
     int size;
     double loadFactorThreshold;
     int rehashCount;
+    bool verbose;            // Сообщать о каждой операции (в бенчмарках выключено)
+    bool incrementalRehash;  // Переносить корзины понемногу, а не все сразу
+    ChainNode** oldTable;    // Корзины, из которых идет перенос (nullptr, если переноса нет)
+    int oldCapacity;
+    int migratePosition;     // Первая еще не перенесенная корзина старой таблицы
 
     ChainingHashTable(int initialCapacity = 8, double threshold = 0.9) 
-        : capacity(initialCapacity), size(0), loadFactorThreshold(threshold), rehashCount(0) {
+        : capacity(initialCapacity), size(0), loadFactorThreshold(threshold), rehashCount(0),
+          verbose(true), incrementalRehash(false), oldTable(nullptr), oldCapacity(0), migratePosition(0) {
         table = new ChainNode*[capacity];
         for (int i = 0; i < capacity; i++) {
             table[i] = nullptr;
@@ -254,26 +557,61 @@ struct ChainingHashTable {
     }
     
     ~ChainingHashTable() {
-        for (int i = 0; i < capacity; i++) {
-            ChainNode* current = table[i];
+        freeBuckets(table, capacity);
+        if (oldTable != nullptr) {
+            freeBuckets(oldTable, oldCapacity);
+        }
+    }
+
+    static void freeBuckets(ChainNode** buckets, int bucketCount) {
+        for (int i = 0; i < bucketCount; i++) {
+            ChainNode* current = buckets[i];
             while (current != nullptr) {
                 ChainNode* next = current->next;
                 delete current;
                 current = next;
             }
         }
-        delete[] table;
+        delete[] buckets;
     }
 
     // Хеш-функция
     int hash(int key) {
-        return key % capacity;
+        return hash(key, capacity);
+    }
+
+    int hash(int key, int tableCapacity) {
+        // Остаток от деления отрицательного ключа отрицателен
+        return (key % tableCapacity + tableCapacity) % tableCapacity;
+    }
+
+    // Поиск узла в цепочке
+    static ChainNode* findInChain(ChainNode* current, int key) {
+        while (current != nullptr && current->key != key) {
+            current = current->next;
+        }
+        return current;
+    }
+
+    // Узел с ключом в старой таблице, если ее корзина еще не перенесена
+    ChainNode* findInOldTable(int key) {
+        if (oldTable == nullptr) {
+            return nullptr;
+        }
+        return findInChain(oldTable[hash(key, oldCapacity)], key);
     }
 
     // Вставка элемента
     void insert(int key, const string& value) {
+        if (oldTable != nullptr) {
+            migrateStep();
+        }
         if (getLoadFactor() >= loadFactorThreshold) {
-            rehash();
+            if (incrementalRehash && oldTable == nullptr) {
+                startRehash();
+            } else {
+                rehash();
+            }
         }
 
         int index = hash(key);
@@ -283,57 +621,85 @@ struct ChainingHashTable {
         while (current != nullptr) {
             if (current->key == key) {
                 current->value = value;
-                cout << "Ключ " << key << " обновлен в корзине " << index << endl;
+                if (verbose) {
+                    cout << "Ключ " << key << " обновлен в корзине " << index << endl;
+                }
                 return;
             }
             current = current->next;
         }
+        ChainNode* oldNode = findInOldTable(key);
+        if (oldNode != nullptr) {
+            oldNode->value = value;
+            if (verbose) {
+                cout << "Ключ " << key << " обновлен в корзине " << hash(key, oldCapacity)
+                     << " старой таблицы" << endl;
+            }
+            return;
+        }
         
         // Добавляем новый узел в начало списка
         ChainNode* newNode = new ChainNode(key, value);
         newNode->next = table[index];
         table[index] = newNode;
         size++;
-        cout << "Ключ " << key << " вставлен в корзину " << index << endl;
+        if (verbose) {
+            cout << "Ключ " << key << " вставлен в корзину " << index << endl;
+        }
     }
 
     // Поиск элемента
     string search(int key) {
-        int index = hash(key);
-        ChainNode* current = table[index];
-        
-        while (current != nullptr) {
-            if (current->key == key) {
-                return current->value;
-            }
-            current = current->next;
+        ChainNode* node = findInChain(table[hash(key)], key);
+        if (node == nullptr) {
+            node = findInOldTable(key);
         }
-        return "Not Found";
+        return node != nullptr ? node->value : "Not Found";
     }
 
-    // Удаление элемента
-    void remove(int key) {
-        int index = hash(key);
-        ChainNode* current = table[index];
+    // Удаление узла с ключом из цепочки; true, если узел был
+    static bool removeFromChain(ChainNode*& head, int key) {
+        ChainNode* current = head;
         ChainNode* prev = nullptr;
         
         while (current != nullptr) {
             if (current->key == key) {
                 if (prev == nullptr) {
                     // Удаляем первый элемент
-                    table[index] = current->next;
+                    head = current->next;
                 } else {
                     prev->next = current->next;
                 }
                 delete current;
-                size--;
-                cout << "Ключ " << key << " удален из корзины " << index << endl;
-                return;
+                return true;
             }
             prev = current;
             current = current->next;
         }
-        cout << "Ключ " << key << " не найден для удаления" << endl;
+        return false;
+    }
+
+    // Удаление элемента
+    void remove(int key) {
+        if (oldTable != nullptr) {
+            migrateStep();
+        }
+        int index = hash(key);
+        bool removed = removeFromChain(table[index], key);
+        if (!removed && oldTable != nullptr) {
+            index = hash(key, oldCapacity);
+            removed = removeFromChain(oldTable[index], key);
+        }
+        if (!removed) {
+            if (verbose) {
+                cout << "Ключ " << key << " не найден для удаления" << endl;
+            }
+            return;
+        }
+        size--;
+        if (verbose) {
+            cout << "Ключ " << key << " удален из корзины " << index << endl;
+        }
     }
 
     // Получение коэффициента загрузки
@@ -341,16 +707,68 @@ struct ChainingHashTable {
         return static_cast<double>(size) / capacity;
     }
 
+    // Перевешивание узлов цепочки в корзины текущей таблицы
+    void moveChain(ChainNode* current) {
+        while (current != nullptr) {
+            ChainNode* next = current->next;
+            int newIndex = hash(current->key);
+            current->next = table[newIndex];
+            table[newIndex] = current;
+            current = next;
+        }
+    }
+
+    // Начало постепенной реструктуризации: новая таблица вдвое больше,
+    // старые корзины переносятся по REHASH_MIGRATE_STEP за insert/remove
+    void startRehash() {
+        rehashCount++;
+        if (verbose) {
+            cout << "\nПостепенная реструктуризация таблицы с цепочками" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        }
+        oldTable = table;
+        oldCapacity = capacity;
+        migratePosition = 0;
+        capacity *= 2;
+        table = new ChainNode*[capacity];
+        for (int i = 0; i < capacity; i++) {
+            table[i] = nullptr;
+        }
+    }
+
+    // Перенос очередной порции корзин из старой таблицы
+    void migrateStep() {
+        int end = min(migratePosition + REHASH_MIGRATE_STEP, oldCapacity);
+        for (; migratePosition < end; migratePosition++) {
+            moveChain(oldTable[migratePosition]);
+            oldTable[migratePosition] = nullptr;
+        }
+        if (migratePosition == oldCapacity) {
+            delete[] oldTable;
+            oldTable = nullptr;
+            if (verbose) {
+                cout << "Реструктуризация завершена!" << endl;
+            }
+        }
+    }
+
     // Реструктуризация таблицы
     void rehash() {
+        // Незавершенный перенос сначала доводится до конца
+        while (oldTable != nullptr) {
+            migrateStep();
+        }
         rehashCount++;
-        cout << "\nРеструктуризация таблицы с цепочками" << endl;
-        cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
-        cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        if (verbose) {
+            cout << "\nРеструктуризация таблицы с цепочками" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        }
 
         // Сохраняем старую таблицу
-        ChainNode** oldTable = table;
-        int oldCapacity = capacity;
+        ChainNode** previousTable = table;
+        int previousCapacity = capacity;
         
         // Создаем новую таблицу
         capacity *= 2;
@@ -358,25 +776,31 @@ struct ChainingHashTable {
         for (int i = 0; i < capacity; i++) {
             table[i] = nullptr;
         }
-        size = 0;
 
         // Переносим элементы из старой таблицы
-        for (int i = 0; i < oldCapacity; i++) {
-            ChainNode* current = oldTable[i];
-            while (current != nullptr) {
-                ChainNode* next = current->next;
-                // Вставляем в новую таблицу
-                int newIndex = hash(current->key);
-                current->next = table[newIndex];
-                table[newIndex] = current;
-                size++;
-                
-                current = next;
-            }
+        for (int i = 0; i < previousCapacity; i++) {
+            moveChain(previousTable[i]);
         }
         
-        delete[] oldTable;
-        cout << "Реструктуризация завершена!" << endl;
+        delete[] previousTable;
+        if (verbose) {
+            cout << "Реструктуризация завершена!" << endl;
+        }
+    }
+
+    // Обход всех элементов (включая еще не перенесенные)
+    template <typename Visit>
+    void forEach(Visit visit) {
+        for (int i = 0; i < capacity; i++) {
+            for (ChainNode* current = table[i]; current != nullptr; current = current->next) {
+                visit(current->key, current->value);
+            }
+        }
+        for (int i = 0; oldTable != nullptr && i < oldCapacity; i++) {
+            for (ChainNode* current = oldTable[i]; current != nullptr; current = current->next) {
+                visit(current->key, current->value);
+            }
+        }
     }
 
     // Вывод всех элементов
@@ -397,6 +821,16 @@ struct ChainingHashTable {
                 isEmpty = false;
             }
         }
+        for (int i = 0; oldTable != nullptr && i < oldCapacity; i++) {
+            if (oldTable[i] != nullptr) {
+                cout << "  Старая корзина " << i << ": ";
+                for (ChainNode* current = oldTable[i]; current != nullptr; current = current->next) {
+                    cout << "[" << current->key << ":'" << current->value << "] ";
+                }
+                cout << endl;
+                isEmpty = false;
+            }
+        }
         if (isEmpty) {
             cout << "  Таблица пуста" << endl;
         }
@@ -430,38 +864,846 @@ struct ChainingHashTable {
         
         cout << "Пустых корзин: " << emptyBuckets << " (" << (emptyBuckets * 100.0 / capacity) << "%)" << endl;
         cout << "Максимальная длина цепочки: " << maxChain << endl;
+        if (oldTable != nullptr) {
+            cout << "Перенесено корзин старой таблицы: " << migratePosition << " из " << oldCapacity << endl;
+        }
     }
 };
 
-// Функция для интерактивной работы с хеш-таблицей
-void interactiveMode() {
-    OpenAddressingHashTable oaHT;
-    ChainingHashTable chHT;
-    
-    int choice;
-    
-    do {
-        cout << "1. Добавить элемент" << endl;
-        cout << "2. Найти элемент" << endl;
-        cout << "3. Удалить элемент" << endl;
-        cout << "4. Показать все элементы" << endl;
-        cout << "5. Показать статистику" << endl;
-        cout << "0. Выход" << endl;
-        cout << "Выберите действие: ";
-        cin >> choice;
-        
-        switch (choice) {
-            case 1: {
-                int key;
-                string value;
-                cout << "Введите ключ (целое число): ";
-                cin >> key;
-                cout << "Введите значение: ";
+// Значения до POOLED_INLINE_VALUE байт хранятся прямо в узле пула
+const int POOLED_INLINE_VALUE = 15;
+const uint8_t POOLED_LONG_VALUE = 0xFF;  // valueLength: значение лежит в longValues
+const uint32_t POOL_NIL = UINT32_MAX;
+
+// Узел пула: 24 байта вместо ChainNode (48 байт плюс заголовок блока кучи)
+struct PooledEntry {
+    int key;
+    uint32_t next;          // Индекс следующего узла цепочки или POOL_NIL
+    uint8_t valueLength;
+    char value[POOLED_INLINE_VALUE];  // Значение или индекс в longValues
+};
+
+// Голова корзины: первый узел и 8-битный фильтр (по биту на отпечаток ключа цепочки),
+// по которому большинство промахов отсекается без обращения к узлам
+struct PooledBucket {
+    uint32_t first;
+    uint8_t filter;
+};
+
+// Хеш-таблица с цепочками в общем пуле узлов: 32-битные индексы вместо указателей,
+// короткие значения без отдельной строки в куче, емкость - степень двойки
+struct PooledChainingHashTable {
+    vector<PooledBucket> buckets;
+    vector<PooledEntry> entries;
+    vector<string> longValues;        // Значения длиннее POOLED_INLINE_VALUE
+    vector<uint32_t> freeLongValues;
+    uint32_t freeEntry;               // Начало списка освободившихся узлов пула
+    int capacity;
+    int size;
+    double loadFactorThreshold;
+    int rehashCount;
+    bool verbose;
+    long long filterRejects;          // Промахи, отсеченные фильтром корзины
+
+    PooledChainingHashTable(int initialCapacity = 8, double threshold = 0.9)
+        : freeEntry(POOL_NIL), capacity(8), size(0), loadFactorThreshold(threshold), rehashCount(0),
+          verbose(true), filterRejects(0) {
+        while (capacity < initialCapacity) capacity *= 2;
+        buckets.assign(capacity, PooledBucket{POOL_NIL, 0});
+    }
+
+    // Бит фильтра по старшим битам перемешанного ключа (младшие дают номер корзины)
+    static uint8_t fingerprintBit(uint64_t mixed) {
+        return static_cast<uint8_t>(1u << (mixed >> 61));
+    }
+
+    string entryValue(const PooledEntry& entry) {
+        if (entry.valueLength != POOLED_LONG_VALUE) {
+            return string(entry.value, entry.valueLength);
+        }
+        uint32_t longIndex;
+        memcpy(&longIndex, entry.value, sizeof(longIndex));
+        return longValues[longIndex];
+    }
+
+    void releaseValue(PooledEntry& entry) {
+        if (entry.valueLength == POOLED_LONG_VALUE) {
+            uint32_t longIndex;
+            memcpy(&longIndex, entry.value, sizeof(longIndex));
+            string().swap(longValues[longIndex]);
+            freeLongValues.push_back(longIndex);
+        }
+        entry.valueLength = 0;
+    }
+
+    void setValue(PooledEntry& entry, const string& value) {
+        releaseValue(entry);
+        if (value.size() <= static_cast<size_t>(POOLED_INLINE_VALUE)) {
+            memcpy(entry.value, value.data(), value.size());
+            entry.valueLength = static_cast<uint8_t>(value.size());
+            return;
+        }
+        uint32_t longIndex;
+        if (!freeLongValues.empty()) {
+            longIndex = freeLongValues.back();
+            freeLongValues.pop_back();
+            longValues[longIndex] = value;
+        } else {
+            longIndex = static_cast<uint32_t>(longValues.size());
+            longValues.push_back(value);
+        }
+        memcpy(entry.value, &longIndex, sizeof(longIndex));
+        entry.valueLength = POOLED_LONG_VALUE;
+    }
+
+    // Вставка элемента
+    void insert(int key, const string& value) {
+        if (getLoadFactor() >= loadFactorThreshold) {
+            rehash();
+        }
+
+        uint64_t mixed = mixKey(key);
+        int index = static_cast<int>(mixed & (capacity - 1));
+        PooledBucket& bucket = buckets[index];
+        if (bucket.filter & fingerprintBit(mixed)) {
+            for (uint32_t i = bucket.first; i != POOL_NIL; i = entries[i].next) {
+                if (entries[i].key == key) {
+                    setValue(entries[i], value);
+                    if (verbose) {
+                        cout << "Ключ " << key << " обновлен в корзине " << index << endl;
+                    }
+                    return;
+                }
+            }
+        }
+
+        uint32_t slot = freeEntry;
+        if (slot != POOL_NIL) {
+            freeEntry = entries[slot].next;
+        } else {
+            slot = static_cast<uint32_t>(entries.size());
+            entries.push_back(PooledEntry());
+        }
+        PooledEntry& entry = entries[slot];
+        entry.key = key;
+        entry.valueLength = 0;
+        setValue(entry, value);
+        entry.next = bucket.first;
+        bucket.first = slot;
+        bucket.filter |= fingerprintBit(mixed);
+        size++;
+        if (verbose) {
+            cout << "Ключ " << key << " вставлен в корзину " << index << endl;
+        }
+    }
+
+    // Поиск элемента
+    string search(int key) {
+        uint64_t mixed = mixKey(key);
+        const PooledBucket& bucket = buckets[mixed & (capacity - 1)];
+        if (!(bucket.filter & fingerprintBit(mixed))) {
+            filterRejects++;
+            return "Not Found";
+        }
+        for (uint32_t i = bucket.first; i != POOL_NIL; i = entries[i].next) {
+            if (entries[i].key == key) {
+                return entryValue(entries[i]);
+            }
+        }
+        return "Not Found";
+    }
+
+    // Удаление элемента
+    void remove(int key) {
+        uint64_t mixed = mixKey(key);
+        int index = static_cast<int>(mixed & (capacity - 1));
+        PooledBucket& bucket = buckets[index];
+        uint32_t prev = POOL_NIL;
+        for (uint32_t i = bucket.first; i != POOL_NIL; prev = i, i = entries[i].next) {
+            if (entries[i].key != key) continue;
+            if (prev == POOL_NIL) {
+                bucket.first = entries[i].next;
+            } else {
+                entries[prev].next = entries[i].next;
+            }
+            releaseValue(entries[i]);
+            entries[i].next = freeEntry;
+            freeEntry = i;
+            size--;
+            // Биты фильтра общие для ключей цепочки, поэтому он пересобирается
+            bucket.filter = 0;
+            for (uint32_t j = bucket.first; j != POOL_NIL; j = entries[j].next) {
+                bucket.filter |= fingerprintBit(mixKey(entries[j].key));
+            }
+            if (verbose) {
+                cout << "Ключ " << key << " удален из корзины " << index << endl;
+            }
+            return;
+        }
+        if (verbose) {
+            cout << "Ключ " << key << " не найден для удаления" << endl;
+        }
+    }
+
+    // Получение коэффициента загрузки
+    double getLoadFactor() {
+        return static_cast<double>(size) / capacity;
+    }
+
+    // Реструктуризация: узлы остаются на месте в пуле, перевешиваются только индексы
+    void rehash() {
+        rehashCount++;
+        if (verbose) {
+            cout << "\nРеструктуризация таблицы с пулом цепочек" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << capacity * 2 << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        }
+        vector<PooledBucket> oldBuckets(capacity * 2, PooledBucket{POOL_NIL, 0});
+        oldBuckets.swap(buckets);
+        capacity *= 2;
+        for (const PooledBucket& oldBucket : oldBuckets) {
+            uint32_t i = oldBucket.first;
+            while (i != POOL_NIL) {
+                uint32_t next = entries[i].next;
+                uint64_t mixed = mixKey(entries[i].key);
+                PooledBucket& bucket = buckets[mixed & (capacity - 1)];
+                entries[i].next = bucket.first;
+                bucket.first = i;
+                bucket.filter |= fingerprintBit(mixed);
+                i = next;
+            }
+        }
+        if (verbose) {
+            cout << "Реструктуризация завершена!" << endl;
+        }
+    }
+
+    // Обход всех элементов
+    template <typename Visit>
+    void forEach(Visit visit) {
+        for (const PooledBucket& bucket : buckets) {
+            for (uint32_t i = bucket.first; i != POOL_NIL; i = entries[i].next) {
+                visit(entries[i].key, entryValue(entries[i]));
+            }
+        }
+    }
+
+    // Вывод всех элементов
+    void printAll() {
+        cout << "\nСодержимое таблицы (Пул цепочек)" << endl;
+        bool isEmpty = true;
+        for (int b = 0; b < capacity; b++) {
+            if (buckets[b].first == POOL_NIL) continue;
+            cout << "  Корзина " << b << ": ";
+            int count = 0;
+            for (uint32_t i = buckets[b].first; i != POOL_NIL; i = entries[i].next) {
+                cout << "[" << entries[i].key << ":'" << entryValue(entries[i]) << "'] ";
+                count++;
+            }
+            cout << "(" << count << " элементов)" << endl;
+            isEmpty = false;
+        }
+        if (isEmpty) {
+            cout << "  Таблица пуста" << endl;
+        }
+    }
+
+    // Вывод статистики
+    void printStats() {
+        cout << "\nСтатистика пула цепочек" << endl;
+        cout << "Размер: " << size << endl;
+        cout << "Емкость: " << capacity << endl;
+        cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        cout << "Количество реструктуризаций: " << rehashCount << endl;
+        
+        int maxChain = 0;
+        int emptyBuckets = 0;
+        for (const PooledBucket& bucket : buckets) {
+            int chainLength = 0;
+            for (uint32_t i = bucket.first; i != POOL_NIL; i = entries[i].next) {
+                chainLength++;
+            }
+            if (chainLength == 0) emptyBuckets++;
+            maxChain = max(maxChain, chainLength);
+        }
+        cout << "Пустых корзин: " << emptyBuckets << " (" << (emptyBuckets * 100.0 / capacity) << "%)" << endl;
+        cout << "Максимальная длина цепочки: " << maxChain << endl;
+        cout << "Узлов в пуле: " << entries.size() << ", длинных значений: "
+             << longValues.size() - freeLongValues.size() << endl;
+        cout << "Промахов, отсеченных фильтром: " << filterRejects << endl;
+    }
+};
+
+// Кукушкино хеширование с корзинами: у ключа ровно две корзины, каждая занимает
+// одну кэш-линию (8 ключей и 8 индексов значений), поэтому поиск ключа читает
+// не более двух кэш-линий (и небольшой тайник, если он не пуст)
+const int CUCKOO_BUCKET_SLOTS = 8;
+const uint32_t CUCKOO_EMPTY = UINT32_MAX;
+const int CUCKOO_MAX_KICKS = 500;        // Вытеснений на одну вставку до перехода в тайник
+const size_t CUCKOO_STASH_SIZE = 8;
+
+struct alignas(64) CuckooBucket {
+    int keys[CUCKOO_BUCKET_SLOTS];
+    uint32_t values[CUCKOO_BUCKET_SLOTS];  // Индекс значения или CUCKOO_EMPTY
+};
+
+struct CuckooEntry {
+    int key;
+    uint32_t value;
+};
+
+struct CuckooHashTable {
+    vector<CuckooBucket> buckets;
+    vector<CuckooEntry> stash;        // Ключи, не нашедшие места за CUCKOO_MAX_KICKS вытеснений
+    vector<string> values;
+    vector<uint32_t> freeValues;
+    int bucketCount;                  // Степень двойки
+    int capacity;                     // Ячеек во всех корзинах
+    int size;
+    double loadFactorThreshold;
+    int rehashCount;
+    bool verbose;
+    uint32_t seed;                    // Меняется при каждой перестройке
+    mt19937 kickGenerator;
+    long long kickCount;
+
+    CuckooHashTable(int initialCapacity = 16, double threshold = 0.9)
+        : bucketCount(2), size(0), loadFactorThreshold(threshold), rehashCount(0), verbose(true),
+          seed(0), kickGenerator(12345), kickCount(0) {
+        while (bucketCount * CUCKOO_BUCKET_SLOTS < initialCapacity) bucketCount *= 2;
+        capacity = bucketCount * CUCKOO_BUCKET_SLOTS;
+        buckets.assign(bucketCount, emptyBucket());
+    }
+
+    static CuckooBucket emptyBucket() {
+        CuckooBucket bucket;
+        for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+            bucket.keys[s] = 0;
+            bucket.values[s] = CUCKOO_EMPTY;
+        }
+        return bucket;
+    }
+
+    // Две корзины ключа; при совпадении вторая - соседняя
+    void bucketsOf(int key, int& first, int& second) {
+        uint64_t mixed = mixKey(key ^ static_cast<int>(seed));
+        first = static_cast<int>(mixed & (bucketCount - 1));
+        second = static_cast<int>((mixed >> 32) & (bucketCount - 1));
+        if (second == first) {
+            second = first ^ 1;
+        }
+    }
+
+    // Ячейка ключа в корзине или -1
+    static int findInBucket(const CuckooBucket& bucket, int key) {
+        for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+            if (bucket.values[s] != CUCKOO_EMPTY && bucket.keys[s] == key) {
+                return s;
+            }
+        }
+        return -1;
+    }
+
+    static bool placeInBucket(CuckooBucket& bucket, const CuckooEntry& entry) {
+        for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+            if (bucket.values[s] == CUCKOO_EMPTY) {
+                bucket.keys[s] = entry.key;
+                bucket.values[s] = entry.value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Индекс значения ключа или CUCKOO_EMPTY
+    uint32_t findValue(int key) {
+        int first, second;
+        bucketsOf(key, first, second);
+        int slot = findInBucket(buckets[first], key);
+        if (slot >= 0) return buckets[first].values[slot];
+        slot = findInBucket(buckets[second], key);
+        if (slot >= 0) return buckets[second].values[slot];
+        for (const CuckooEntry& entry : stash) {
+            if (entry.key == key) return entry.value;
+        }
+        return CUCKOO_EMPTY;
+    }
+
+    uint32_t storeValue(const string& value) {
+        if (!freeValues.empty()) {
+            uint32_t index = freeValues.back();
+            freeValues.pop_back();
+            values[index] = value;
+            return index;
+        }
+        values.push_back(value);
+        return static_cast<uint32_t>(values.size() - 1);
+    }
+
+    // Размещение с вытеснениями; если и тайник полон, бездомный элемент
+    // возвращается в homeless, и таблицу нужно перестроить
+    bool place(CuckooEntry entry, CuckooEntry& homeless) {
+        int first, second;
+        bucketsOf(entry.key, first, second);
+        if (placeInBucket(buckets[first], entry) || placeInBucket(buckets[second], entry)) {
+            return true;
+        }
+        int current = kickGenerator() & 1 ? first : second;
+        for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+            int slot = static_cast<int>(kickGenerator() % CUCKOO_BUCKET_SLOTS);
+            CuckooBucket& bucket = buckets[current];
+            swap(entry.key, bucket.keys[slot]);
+            swap(entry.value, bucket.values[slot]);
+            kickCount++;
+            bucketsOf(entry.key, first, second);
+            current = current == first ? second : first;
+            if (placeInBucket(buckets[current], entry)) {
+                return true;
+            }
+        }
+        if (stash.size() < CUCKOO_STASH_SIZE) {
+            stash.push_back(entry);
+            return true;
+        }
+        homeless = entry;
+        return false;
+    }
+
+    // Вставка элемента
+    void insert(int key, const string& value) {
+        uint32_t existing = findValue(key);
+        if (existing != CUCKOO_EMPTY) {
+            values[existing] = value;
+            if (verbose) {
+                cout << "Ключ " << key << " обновлен" << endl;
+            }
+            return;
+        }
+        if (getLoadFactor() >= loadFactorThreshold) {
+            rehash(bucketCount * 2, nullptr);
+        }
+
+        CuckooEntry homeless;
+        if (!place(CuckooEntry{key, storeValue(value)}, homeless)) {
+            // Вытеснения зациклились: новое зерно хеша в том же размере, при неудаче - вдвое больше
+            rehash(bucketCount, &homeless);
+        }
+        size++;
+        if (verbose) {
+            int first, second;
+            bucketsOf(key, first, second);
+            cout << "Ключ " << key << " вставлен (корзины " << first << " и " << second << ")" << endl;
+        }
+    }
+
+    // Поиск элемента
+    string search(int key) {
+        uint32_t index = findValue(key);
+        return index != CUCKOO_EMPTY ? values[index] : "Not Found";
+    }
+
+    // Удаление элемента
+    void remove(int key) {
+        int first, second;
+        bucketsOf(key, first, second);
+        uint32_t index = CUCKOO_EMPTY;
+        for (int b : {first, second}) {
+            int slot = findInBucket(buckets[b], key);
+            if (slot >= 0) {
+                index = buckets[b].values[slot];
+                buckets[b].values[slot] = CUCKOO_EMPTY;
+                break;
+            }
+        }
+        for (size_t i = 0; index == CUCKOO_EMPTY && i < stash.size(); i++) {
+            if (stash[i].key == key) {
+                index = stash[i].value;
+                stash[i] = stash.back();
+                stash.pop_back();
+            }
+        }
+        if (index == CUCKOO_EMPTY) {
+            if (verbose) {
+                cout << "Ключ " << key << " не найден для удаления" << endl;
+            }
+            return;
+        }
+        string().swap(values[index]);
+        freeValues.push_back(index);
+        size--;
+        if (verbose) {
+            cout << "Ключ " << key << " удален" << endl;
+        }
+    }
+
+    // Получение коэффициента загрузки
+    double getLoadFactor() {
+        return static_cast<double>(size) / capacity;
+    }
+
+    // Перестройка с новым зерном хеша в newBucketCount корзин (плюс элемент extra);
+    // если размещение снова не удается, число корзин удваивается
+    void rehash(int newBucketCount, const CuckooEntry* extra) {
+        rehashCount++;
+        if (verbose) {
+            cout << "\nРеструктуризация кукушкиной таблицы" << endl;
+            cout << "Старая емкость: " << capacity << " -> Новая емкость: " << newBucketCount * CUCKOO_BUCKET_SLOTS << endl;
+            cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        }
+        vector<CuckooEntry> entries(stash);
+        if (extra != nullptr) {
+            entries.push_back(*extra);
+        }
+        for (const CuckooBucket& bucket : buckets) {
+            for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+                if (bucket.values[s] != CUCKOO_EMPTY) {
+                    entries.push_back(CuckooEntry{bucket.keys[s], bucket.values[s]});
+                }
+            }
+        }
+        
+        while (true) {
+            seed = kickGenerator();
+            bucketCount = newBucketCount;
+            capacity = bucketCount * CUCKOO_BUCKET_SLOTS;
+            buckets.assign(bucketCount, emptyBucket());
+            stash.clear();
+            bool placed = true;
+            CuckooEntry homeless;
+            for (const CuckooEntry& entry : entries) {
+                if (!place(entry, homeless)) {
+                    placed = false;
+                    break;
+                }
+            }
+            if (placed) break;
+            newBucketCount *= 2;
+        }
+        if (verbose) {
+            cout << "Реструктуризация завершена!" << endl;
+        }
+    }
+
+    // Обход всех элементов
+    template <typename Visit>
+    void forEach(Visit visit) {
+        for (const CuckooBucket& bucket : buckets) {
+            for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+                if (bucket.values[s] != CUCKOO_EMPTY) {
+                    visit(bucket.keys[s], values[bucket.values[s]]);
+                }
+            }
+        }
+        for (const CuckooEntry& entry : stash) {
+            visit(entry.key, values[entry.value]);
+        }
+    }
+
+    // Вывод всех элементов
+    void printAll() {
+        cout << "\nСодержимое таблицы (Кукушкино хеширование)" << endl;
+        bool isEmpty = true;
+        for (int b = 0; b < bucketCount; b++) {
+            bool printed = false;
+            for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+                if (buckets[b].values[s] == CUCKOO_EMPTY) continue;
+                if (!printed) {
+                    cout << "  Корзина " << b << ": ";
+                    printed = true;
+                }
+                cout << "[" << buckets[b].keys[s] << ":'" << values[buckets[b].values[s]] << "'] ";
+            }
+            if (printed) {
+                cout << endl;
+                isEmpty = false;
+            }
+        }
+        if (!stash.empty()) {
+            cout << "  Тайник: ";
+            for (const CuckooEntry& entry : stash) {
+                cout << "[" << entry.key << ":'" << values[entry.value] << "'] ";
+            }
+            cout << endl;
+            isEmpty = false;
+        }
+        if (isEmpty) {
+            cout << "  Таблица пуста" << endl;
+        }
+    }
+
+    // Вывод статистики
+    void printStats() {
+        cout << "\nСтатистика кукушкиного хеширования" << endl;
+        cout << "Размер: " << size << endl;
+        cout << "Емкость: " << capacity << " (" << bucketCount << " корзин по " << CUCKOO_BUCKET_SLOTS << ")" << endl;
+        cout << "Коэффициент загрузки: " << getLoadFactor() << endl;
+        cout << "Количество реструктуризаций: " << rehashCount << endl;
+        cout << "Элементов в тайнике: " << stash.size() << endl;
+        cout << "Вытеснений: " << kickCount << endl;
+        cout << "Кэш-линий на поиск: не более 2" << (stash.empty() ? "" : " и тайник") << endl;
+    }
+};
+
+// Снимок таблицы: заголовок, массив ячеек неизменяемой таблицы с линейным
+// пробированием и арена значений. Значения адресуются смещениями от начала арены,
+// поэтому файл можно отобразить в память по любому адресу и искать в нем сразу
+struct SnapshotHeader {
+    char magic[4];        // "HTSN"
+    uint32_t version;
+    uint64_t slotCount;
+    uint64_t size;
+    uint64_t arenaBytes;
+};
+
+struct SnapshotSlot {
+    int32_t key;
+    uint32_t valueLength;   // SNAPSHOT_EMPTY - пустая ячейка
+    uint64_t valueOffset;
+};
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_EMPTY = UINT32_MAX;
+const double SNAPSHOT_MAX_LOAD = 0.75;
+
+// Начальная ячейка ключа: перемешанный ключ, отображенный на [0, slotCount) умножением
+inline uint64_t snapshotIndex(int key, uint64_t slotCount) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(mixKey(key)) * slotCount) >> 64);
+}
+
+// Построение снимка из заранее известного числа различных ключей
+struct SnapshotWriter {
+    vector<SnapshotSlot> slots;
+    string arena;
+    uint64_t size;
+
+    SnapshotWriter(uint64_t entryCount) : size(0) {
+        uint64_t slotCount = max<uint64_t>(1, static_cast<uint64_t>(entryCount / SNAPSHOT_MAX_LOAD) + 1);
+        slots.assign(slotCount, SnapshotSlot{0, SNAPSHOT_EMPTY, 0});
+    }
+
+    void add(int key, const string& value) {
+        uint64_t index = snapshotIndex(key, slots.size());
+        while (slots[index].valueLength != SNAPSHOT_EMPTY) {
+            if (++index == slots.size()) index = 0;
+        }
+        slots[index] = SnapshotSlot{key, static_cast<uint32_t>(value.size()), arena.size()};
+        arena += value;
+        size++;
+    }
+
+    bool save(const string& filename) {
+        FILE* output = fopen(filename.c_str(), "wb");
+        if (!output) {
+            cerr << "Ошибка: Не удалось открыть файл " << filename << " для записи" << endl;
+            return false;
+        }
+        SnapshotHeader header;
+        memcpy(header.magic, "HTSN", 4);
+        header.version = SNAPSHOT_VERSION;
+        header.slotCount = slots.size();
+        header.size = size;
+        header.arenaBytes = arena.size();
+        bool written = fwrite(&header, sizeof(header), 1, output) == 1 &&
+                       fwrite(slots.data(), sizeof(SnapshotSlot), slots.size(), output) == slots.size() &&
+                       fwrite(arena.data(), 1, arena.size(), output) == arena.size();
+        written = fclose(output) == 0 && written;
+        if (!written) {
+            cerr << "Ошибка: не удалось записать снимок в файл " << filename << endl;
+        }
+        return written;
+    }
+};
+
+// Сохранение любой таблицы этого файла (таблица перечисляет элементы через forEach)
+template <typename Table>
+bool saveSnapshot(Table& hashTable, const string& filename) {
+    SnapshotWriter writer(static_cast<uint64_t>(hashTable.size));
+    hashTable.forEach([&](int key, const string& value) {
+        writer.add(key, value);
+    });
+    return writer.save(filename);
+}
+
+// Снимок, отображенный в память: загрузка не читает и не перехеширует элементы,
+// страницы подгружаются при первом обращении
+struct MappedHashSnapshot {
+    void* mapping;
+    size_t mappingSize;
+    const SnapshotHeader* header;
+    const SnapshotSlot* slots;
+    const char* arena;
+
+    MappedHashSnapshot() : mapping(MAP_FAILED), mappingSize(0), header(nullptr), slots(nullptr), arena(nullptr) {}
+
+    ~MappedHashSnapshot() {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mappingSize);
+        }
+    }
+
+    bool open(const string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Ошибка: Не удалось открыть файл " << filename << " для чтения" << endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+            cerr << "Ошибка: файл " << filename << " не является снимком таблицы" << endl;
+            close(fd);
+            return false;
+        }
+        mappingSize = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            cerr << "Ошибка: не удалось отобразить файл " << filename << " в память" << endl;
+            return false;
+        }
+        // Обращения к ячейкам случайны, упреждающее чтение только мешает
+        madvise(mapping, mappingSize, MADV_RANDOM);
+        
+        // Заголовок сверяется с размером файла без переполнений: ячеек не больше, чем
+        // помещается в файл, арена - ровно остаток файла, загрузка - не выше, чем
+        // при записи. Сами ячейки не читаются, чтобы открытие не трогало весь файл;
+        // от испорченных ячеек защищают проверки при поиске
+        header = static_cast<const SnapshotHeader*>(mapping);
+        slots = reinterpret_cast<const SnapshotSlot*>(static_cast<const char*>(mapping) + sizeof(SnapshotHeader));
+        size_t payloadBytes = mappingSize - sizeof(SnapshotHeader);
+        bool valid = string(header->magic, 4) == "HTSN" && header->version == SNAPSHOT_VERSION &&
+                     header->slotCount > header->size &&
+                     header->size <= header->slotCount * SNAPSHOT_MAX_LOAD &&
+                     header->slotCount <= payloadBytes / sizeof(SnapshotSlot) &&
+                     header->arenaBytes == payloadBytes - header->slotCount * sizeof(SnapshotSlot);
+        if (!valid) {
+            cerr << "Ошибка: файл " << filename << " не является снимком таблицы или поврежден" << endl;
+            return false;
+        }
+        arena = reinterpret_cast<const char*>(slots + header->slotCount);
+        return true;
+    }
+
+    // Поиск элемента (линейное пробирование до пустой ячейки, но не больше slotCount
+    // проб: в испорченном файле пустых ячеек может не оказаться)
+    string search(int key) const {
+        uint64_t index = snapshotIndex(key, header->slotCount);
+        for (uint64_t probes = 0; probes < header->slotCount; probes++) {
+            const SnapshotSlot& slot = slots[index];
+            if (slot.valueLength == SNAPSHOT_EMPTY) {
+                break;
+            }
+            if (slot.key == key) {
+                if (slot.valueLength > header->arenaBytes ||
+                    slot.valueOffset > header->arenaBytes - slot.valueLength) {
+                    return "Not Found";  // Поврежденная ячейка
+                }
+                return string(arena + slot.valueOffset, slot.valueLength);
+            }
+            if (++index == header->slotCount) index = 0;
+        }
+        return "Not Found";
+    }
+
+    void printStats() const {
+        cout << "\nСтатистика снимка" << endl;
+        cout << "Размер: " << header->size << endl;
+        cout << "Ячеек: " << header->slotCount << endl;
+        cout << "Коэффициент загрузки: " << static_cast<double>(header->size) / header->slotCount << endl;
+        cout << "Арена значений: " << header->arenaBytes << " байт" << endl;
+    }
+};
+
+// Построение снимка из count синтетических элементов (ключ i, значение "value<i>")
+int runBuildSnapshot(const string& filename, int count) {
+    auto start = chrono::steady_clock::now();
+    SnapshotWriter writer(static_cast<uint64_t>(count));
+    for (int i = 0; i < count; i++) {
+        writer.add(i, "value" + to_string(i));
+    }
+    auto built = chrono::steady_clock::now();
+    if (!writer.save(filename)) {
+        return 1;
+    }
+    auto saved = chrono::steady_clock::now();
+    cerr << "Элементов: " << count << ", построение: " << chrono::duration<double>(built - start).count()
+         << " с, запись: " << chrono::duration<double>(saved - built).count() << " с" << endl;
+    return 0;
+}
+
+// Загрузка снимка и поиск ключей из stdin (по одному на строку) либо lookupCount
+// случайных запросов для замера скорости
+int runSnapshotMode(const string& filename, int lookupCount) {
+    auto start = chrono::steady_clock::now();
+    MappedHashSnapshot snapshot;
+    if (!snapshot.open(filename)) {
+        return 1;
+    }
+    double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cerr << "Снимок загружен за " << loadMs << " мс (" << snapshot.header->size << " элементов)" << endl;
+    
+    if (lookupCount > 0) {
+        mt19937 generator(42);
+        // Ключи в два раза шире числа элементов: около половины запросов - промахи
+        uint64_t keyRange = max<uint64_t>(1, min<uint64_t>(snapshot.header->size * 2, INT_MAX));
+        size_t found = 0;
+        auto lookupStart = chrono::steady_clock::now();
+        for (int i = 0; i < lookupCount; i++) {
+            found += snapshot.search(static_cast<int>(generator() % keyRange)) != "Not Found";
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - lookupStart).count();
+        cout << "Запросов: " << lookupCount << ", найдено: " << found << ", " << lookupCount / seconds
+             << " запросов/с" << endl;
+        return 0;
+    }
+    
+    string line;
+    while (getline(cin, line)) {
+        if (line.empty()) continue;
+        try {
+            int key = stoi(line);
+            cout << key << " -> '" << snapshot.search(key) << "'" << endl;
+        } catch (const exception&) {
+            cerr << "Ошибка: ключ должен быть целым числом: " << line << endl;
+        }
+    }
+    return 0;
+}
+
+// Функция для интерактивной работы с хеш-таблицей
+void interactiveMode(bool incremental, bool powerOfTwo) {
+    OpenAddressingHashTable oaHT(8, 0.9, powerOfTwo);
+    ChainingHashTable chHT;
+    CuckooHashTable ckHT;
+    oaHT.incrementalRehash = incremental;
+    chHT.incrementalRehash = incremental;
+    
+    int choice;
+    
+    do {
+        cout << "1. Добавить элемент" << endl;
+        cout << "2. Найти элемент" << endl;
+        cout << "3. Удалить элемент" << endl;
+        cout << "4. Показать все элементы" << endl;
+        cout << "5. Показать статистику" << endl;
+        cout << "6. Сохранить снимок в файл" << endl;
+        cout << "7. Открыть снимок и найти элемент" << endl;
+        cout << "0. Выход" << endl;
+        cout << "Выберите действие: ";
+        cin >> choice;
+        
+        switch (choice) {
+            case 1: {
+                int key;
+                string value;
+                cout << "Введите ключ (целое число): ";
+                cin >> key;
+                cout << "Введите значение: ";
                 cin.ignore();
                 getline(cin, value);
                 
                 oaHT.insert(key, value);
                 chHT.insert(key, value);
+                ckHT.insert(key, value);
                 break;
             }
             case 2: {
@@ -471,10 +1713,12 @@ void interactiveMode() {
                 
                 string resultOA = oaHT.search(key);
                 string resultCH = chHT.search(key);
+                string resultCK = ckHT.search(key);
                 
                 cout << "Результат поиска:" << endl;
                 cout << "  Открытая адресация: ключ " << key << " -> '" << resultOA << "'" << endl;
                 cout << "  Метод цепочек: ключ " << key << " -> '" << resultCH << "'" << endl;
+                cout << "  Кукушкино хеширование: ключ " << key << " -> '" << resultCK << "'" << endl;
                 break;
             }
             case 3: {
@@ -484,16 +1728,42 @@ void interactiveMode() {
                 
                 oaHT.remove(key);
                 chHT.remove(key);
+                ckHT.remove(key);
                 break;
             }
             case 4: {
                 oaHT.printAll();
                 chHT.printAll();
+                ckHT.printAll();
                 break;
             }
             case 5: {
                 oaHT.printStats();
                 chHT.printStats();
+                ckHT.printStats();
+                break;
+            }
+            case 6: {
+                string filename;
+                cout << "Введите имя файла: ";
+                cin >> filename;
+                // Содержимое всех таблиц одинаково, сохраняется таблица с цепочками
+                if (saveSnapshot(chHT, filename)) {
+                    cout << "Снимок из " << chHT.size << " элементов сохранен в " << filename << endl;
+                }
+                break;
+            }
+            case 7: {
+                string filename;
+                int key;
+                cout << "Введите имя файла: ";
+                cin >> filename;
+                cout << "Введите ключ для поиска: ";
+                cin >> key;
+                MappedHashSnapshot snapshot;
+                if (snapshot.open(filename)) {
+                    cout << "  Снимок: ключ " << key << " -> '" << snapshot.search(key) << "'" << endl;
+                }
                 break;
             }
             case 0:
@@ -505,10 +1775,722 @@ void interactiveMode() {
     } while (choice != 0);
 }
 
-int main() {
+// Процентиль задержек; latencies переупорядочивается
+double latencyPercentile(vector<double>& latencies, double fraction) {
+    size_t index = min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()));
+    nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+    return latencies[index];
+}
+
+// Задержки отдельных вставок в таблицу при полной или постепенной реструктуризации
+template <typename Table>
+void measureInsertLatency(const string& name, bool incremental, const vector<int>& keys) {
+    Table hashTable;
+    hashTable.verbose = false;
+    hashTable.incrementalRehash = incremental;
+    vector<double> latencies(keys.size());
+    const string value = "value";
+    
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto before = chrono::steady_clock::now();
+        hashTable.insert(keys[i], value);
+        latencies[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - before).count();
+    }
+    double totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    double maxLatency = *max_element(latencies.begin(), latencies.end());
+    double p50 = latencyPercentile(latencies, 0.5);
+    double p99 = latencyPercentile(latencies, 0.99);
+    double p999 = latencyPercentile(latencies, 0.999);
+    cout << name << (incremental ? ", постепенно" : ", сразу") << ": p50=" << p50 << " p99=" << p99
+         << " p999=" << p999 << " max=" << maxLatency << " мкс; всего " << totalSeconds
+         << " с, реструктуризаций: " << hashTable.rehashCount << endl;
+}
+
+int runRehashBenchmark(int count) {
+    mt19937 generator(42);
+    uniform_int_distribution<int> keyDist(0, INT_MAX);
+    vector<int> keys(count);
+    for (int& key : keys) {
+        key = keyDist(generator);
+    }
+    
+    cout << "Вставок: " << count << endl;
+    measureInsertLatency<OpenAddressingHashTable>("Открытая адресация", false, keys);
+    measureInsertLatency<OpenAddressingHashTable>("Открытая адресация", true, keys);
+    measureInsertLatency<ChainingHashTable>("Метод цепочек", false, keys);
+    measureInsertLatency<ChainingHashTable>("Метод цепочек", true, keys);
+    return 0;
+}
+
+// Поток удалений и вставок при постоянном размере: средняя длина проб при поиске
+// существующих и отсутствующих ключей с учетом удаленных ячеек и без него
+int runChurnBenchmark(int count) {
+    const int rounds = 8;
+    const int lookups = max(1, count / 20);
+    
+    for (bool countTombstones : {false, true}) {
+        cout << (countTombstones ? "С учетом удаленных ячеек:" : "Без учета удаленных ячеек:") << endl;
+        OpenAddressingHashTable hashTable;
+        hashTable.verbose = false;
+        hashTable.countTombstones = countTombstones;
+        mt19937 generator(42);
+        uniform_int_distribution<int> keyDist(0, INT_MAX / 2);
+        
+        // Живые ключи четные, отсутствующие - нечетные
+        vector<int> live(count);
+        for (int& key : live) {
+            key = keyDist(generator) * 2;
+            hashTable.insert(key, "value");
+        }
+        
+        for (int round = 1; round <= rounds; round++) {
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < count; i++) {
+                int& key = live[generator() % count];
+                hashTable.remove(key);
+                key = keyDist(generator) * 2;
+                hashTable.insert(key, "value");
+            }
+            double churnSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            
+            long long before = hashTable.probeCount;
+            for (int i = 0; i < lookups; i++) {
+                hashTable.search(live[generator() % count]);
+            }
+            double hitProbes = static_cast<double>(hashTable.probeCount - before) / lookups;
+            before = hashTable.probeCount;
+            for (int i = 0; i < lookups; i++) {
+                hashTable.search(keyDist(generator) * 2 + 1);
+            }
+            double missProbes = static_cast<double>(hashTable.probeCount - before) / lookups;
+            
+            cout << "  Раунд " << round << ": пробы при попадании " << hitProbes << ", при промахе " << missProbes
+                 << ", емкость " << hashTable.capacity << ", удаленных " << hashTable.deletedCount
+                 << ", очисток " << hashTable.compactionCount << ", " << count / churnSeconds << " операций/с" << endl;
+        }
+    }
+    return 0;
+}
+
+// Ключи для сравнения индексации: подряд идущие, кратные 4096 (при делении на емкость
+// 8 * 2^k они попадают в малую долю ячеек) и случайные
+vector<int> benchmarkKeys(const string& pattern, int count, mt19937& generator) {
+    vector<int> keys(count);
+    for (int i = 0; i < count; i++) {
+        if (pattern == "sequential") {
+            keys[i] = i;
+        } else if (pattern == "stride") {
+            keys[i] = static_cast<int>((static_cast<long long>(i) * 4096) % INT_MAX);
+        } else {
+            keys[i] = static_cast<int>(generator() & INT_MAX);
+        }
+    }
+    return keys;
+}
+
+int runHashBenchmark(int count) {
+    mt19937 generator(42);
+    for (const string pattern : {"sequential", "stride", "random"}) {
+        vector<int> keys = benchmarkKeys(pattern, count, generator);
+        // Отсутствующие ключи того же вида: продолжение последовательности,
+        // середины шагов и отрицательные для случайных
+        vector<int> missing(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (pattern == "sequential") {
+                missing[i] = count + static_cast<int>(i);
+            } else if (pattern == "stride") {
+                missing[i] = keys[i] + 2048;
+            } else {
+                missing[i] = -1 - keys[i];
+            }
+        }
+        
+        for (bool powerOfTwo : {false, true}) {
+            OpenAddressingHashTable hashTable(8, 0.9, powerOfTwo);
+            hashTable.verbose = false;
+            
+            auto start = chrono::steady_clock::now();
+            for (int key : keys) hashTable.insert(key, "value");
+            auto inserted = chrono::steady_clock::now();
+            long long before = hashTable.probeCount;
+            for (int key : keys) hashTable.search(key);
+            double hitProbes = static_cast<double>(hashTable.probeCount - before) / count;
+            auto searched = chrono::steady_clock::now();
+            before = hashTable.probeCount;
+            for (int key : missing) hashTable.search(key);
+            double missProbes = static_cast<double>(hashTable.probeCount - before) / count;
+            auto finished = chrono::steady_clock::now();
+            
+            cout << pattern << (powerOfTwo ? ", маска: " : ", деление: ")
+                 << "вставка " << count / chrono::duration<double>(inserted - start).count() << " оп/с, "
+                 << "поиск " << count / chrono::duration<double>(searched - inserted).count() << " оп/с, "
+                 << "промах " << count / chrono::duration<double>(finished - searched).count() << " оп/с; "
+                 << "пробы " << hitProbes << " / " << missProbes << ", емкость " << hashTable.capacity
+                 << ", реструктуризаций " << hashTable.rehashCount << endl;
+        }
+    }
+    return 0;
+}
+
+// Резидентная память процесса в байтах (по /proc/self/statm)
+size_t residentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Память на элемент и скорость поиска для одной раскладки цепочек
+template <typename Table>
+void measureChainLayout(const string& name, const vector<int>& keys, const vector<int>& missing) {
+    // Освобожденная предыдущей таблицей память возвращается системе, чтобы не исказить замер
+    malloc_trim(0);
+    size_t residentBefore = residentBytes();
+    Table hashTable;
+    hashTable.verbose = false;
+    for (int key : keys) {
+        hashTable.insert(key, "value");
+    }
+    size_t used = residentBytes() - residentBefore;
+    
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : keys) found += hashTable.search(key) != "Not Found";
+    auto searched = chrono::steady_clock::now();
+    for (int key : missing) found += hashTable.search(key) != "Not Found";
+    auto finished = chrono::steady_clock::now();
+    
+    cout << name << ": " << static_cast<double>(used) / keys.size() << " байт на элемент, поиск "
+         << keys.size() / chrono::duration<double>(searched - start).count() << " оп/с, промах "
+         << missing.size() / chrono::duration<double>(finished - searched).count() << " оп/с (найдено "
+         << found << ")" << endl;
+}
+
+int runPoolBenchmark(int count) {
+    mt19937 generator(42);
+    vector<int> keys(count), missing(count);
+    for (int i = 0; i < count; i++) {
+        // Вставляемые ключи меньше 2^30, отсутствующие - не меньше
+        keys[i] = static_cast<int>(generator() & 0x3FFFFFFF);
+        missing[i] = static_cast<int>(generator() | 0x40000000) & INT_MAX;
+    }
+    cout << "Ключей: " << count << endl;
+    measureChainLayout<PooledChainingHashTable>("Пул цепочек", keys, missing);
+    measureChainLayout<ChainingHashTable>("Метод цепочек", keys, missing);
+    return 0;
+}
+
+// Обертка над std::unordered_map с интерфейсом таблиц этого файла (для сравнения)
+struct StdHashTable {
+    unordered_map<int, string> table;
+    int rehashCount;
+    bool verbose;  // Не используется: обертка ничего не выводит
+    size_t lastBucketCount;
+
+    StdHashTable() : rehashCount(0), verbose(false), lastBucketCount(table.bucket_count()) {}
+
+    void insert(int key, const string& value) {
+        table[key] = value;
+        if (table.bucket_count() != lastBucketCount) {
+            lastBucketCount = table.bucket_count();
+            rehashCount++;
+        }
+    }
+
+    string search(int key) {
+        auto it = table.find(key);
+        return it != table.end() ? it->second : "Not Found";
+    }
+
+    void remove(int key) {
+        table.erase(key);
+    }
+};
+
+// Открытая адресация в режиме степени двойки (для сравнения в одной нагрузке)
+struct PowerOfTwoHashTable : OpenAddressingHashTable {
+    PowerOfTwoHashTable() : OpenAddressingHashTable(8, 0.9, true) {}
+};
+
+// Операция рабочей нагрузки
+struct WorkloadOp {
+    enum Type : uint8_t { INSERT, SEARCH, REMOVE } type;
+    int key;
+};
+
+// Параметры нагрузки: распределение ключей, их число, доли операций в процентах
+struct WorkloadConfig {
+    string distribution = "uniform";
+    int keySpace = 1000000;
+    int operations = 5000000;
+    int prefill = -1;               // По умолчанию половина пространства ключей
+    int insertPercent = 50;
+    int searchPercent = 40;
+    int removePercent = 10;
+    double zipfExponent = 0.99;
+    unsigned seed = 42;
+};
+
+// Генератор ключей: равномерно, по порядку (по кругу) или по закону Ципфа
+// (ключ - ранг, ключ 0 самый частый)
+struct KeyGenerator {
+    string distribution;
+    int keySpace;
+    int next;
+    vector<double> zipfCdf;
+
+    KeyGenerator(const WorkloadConfig& config) : distribution(config.distribution), keySpace(config.keySpace), next(0) {
+        if (distribution == "zipf") {
+            zipfCdf.resize(keySpace);
+            double sum = 0;
+            for (int rank = 0; rank < keySpace; rank++) {
+                sum += 1.0 / pow(rank + 1.0, config.zipfExponent);
+                zipfCdf[rank] = sum;
+            }
+            for (double& value : zipfCdf) value /= sum;
+        }
+    }
+
+    int operator()(mt19937& generator) {
+        if (distribution == "sequential") {
+            int key = next;
+            next = next + 1 < keySpace ? next + 1 : 0;
+            return key;
+        }
+        if (distribution == "zipf") {
+            double u = uniform_real_distribution<double>(0.0, 1.0)(generator);
+            return static_cast<int>(lower_bound(zipfCdf.begin(), zipfCdf.end(), u) - zipfCdf.begin());
+        }
+        return static_cast<int>(generator() % keySpace);
+    }
+};
+
+// Результат прогона одной таблицы
+struct WorkloadResult {
+    string table;
+    double opsPerSecond;
+    double p50, p99, p999, maxLatency;  // наносекунды
+    long long memoryBytes;
+    int rehashCount;
+    int size;
+    double avgLookup;   // Средняя длина успешного поиска (ячеек или узлов)
+    int maxLookup;
+};
+
+// Длина успешного поиска каждого ключа: пробы для открытой адресации,
+// позиция в цепочке для остальных таблиц
+void lookupLengths(OpenAddressingHashTable& hashTable, double& average, int& maximum) {
+    long long total = 0;
+    maximum = 0;
+    for (int i = 0; i < hashTable.capacity; i++) {
+        int key;
+        if (!hashTable.cellKey(hashTable.table->data[i], key)) continue;
+        long long before = hashTable.probeCount;
+        hashTable.search(key);
+        int length = static_cast<int>(hashTable.probeCount - before);
+        total += length;
+        maximum = max(maximum, length);
+    }
+    average = hashTable.size > 0 ? static_cast<double>(total) / hashTable.size : 0;
+}
+
+void lookupLengths(ChainingHashTable& hashTable, double& average, int& maximum) {
+    long long total = 0;
+    maximum = 0;
+    for (int i = 0; i < hashTable.capacity; i++) {
+        int position = 0;
+        for (ChainNode* current = hashTable.table[i]; current != nullptr; current = current->next) {
+            total += ++position;
+        }
+        maximum = max(maximum, position);
+    }
+    average = hashTable.size > 0 ? static_cast<double>(total) / hashTable.size : 0;
+}
+
+void lookupLengths(PooledChainingHashTable& hashTable, double& average, int& maximum) {
+    long long total = 0;
+    maximum = 0;
+    for (const PooledBucket& bucket : hashTable.buckets) {
+        int position = 0;
+        for (uint32_t i = bucket.first; i != POOL_NIL; i = hashTable.entries[i].next) {
+            total += ++position;
+        }
+        maximum = max(maximum, position);
+    }
+    average = hashTable.size > 0 ? static_cast<double>(total) / hashTable.size : 0;
+}
+
+// Для кукушкиной таблицы - число просмотренных мест: первая корзина, вторая, тайник
+void lookupLengths(CuckooHashTable& hashTable, double& average, int& maximum) {
+    long long total = 0;
+    maximum = 0;
+    for (int b = 0; b < hashTable.bucketCount; b++) {
+        for (int s = 0; s < CUCKOO_BUCKET_SLOTS; s++) {
+            if (hashTable.buckets[b].values[s] == CUCKOO_EMPTY) continue;
+            int first, second;
+            hashTable.bucketsOf(hashTable.buckets[b].keys[s], first, second);
+            int length = b == first ? 1 : 2;
+            total += length;
+            maximum = max(maximum, length);
+        }
+    }
+    total += 3 * static_cast<long long>(hashTable.stash.size());
+    if (!hashTable.stash.empty()) maximum = 3;
+    average = hashTable.size > 0 ? static_cast<double>(total) / hashTable.size : 0;
+}
+
+void lookupLengths(StdHashTable& hashTable, double& average, int& maximum) {
+    long long total = 0;
+    maximum = 0;
+    for (size_t b = 0; b < hashTable.table.bucket_count(); b++) {
+        long long length = static_cast<long long>(hashTable.table.bucket_size(b));
+        total += length * (length + 1) / 2;
+        maximum = max(maximum, static_cast<int>(length));
+    }
+    average = hashTable.table.empty() ? 0 : static_cast<double>(total) / hashTable.table.size();
+}
+
+int tableSize(OpenAddressingHashTable& hashTable) { return hashTable.size; }
+int tableSize(ChainingHashTable& hashTable) { return hashTable.size; }
+int tableSize(PooledChainingHashTable& hashTable) { return hashTable.size; }
+int tableSize(CuckooHashTable& hashTable) { return hashTable.size; }
+int tableSize(StdHashTable& hashTable) { return static_cast<int>(hashTable.table.size()); }
+
+// Выполнение операций; при latencies != nullptr замеряется каждая операция
+template <typename Table>
+void applyWorkload(Table& hashTable, const vector<WorkloadOp>& ops, vector<double>* latencies) {
+    const string value = "value";
+    size_t found = 0;
+    for (size_t i = 0; i < ops.size(); i++) {
+        auto before = latencies ? chrono::steady_clock::now() : chrono::steady_clock::time_point();
+        const WorkloadOp& op = ops[i];
+        if (op.type == WorkloadOp::INSERT) {
+            hashTable.insert(op.key, value);
+        } else if (op.type == WorkloadOp::SEARCH) {
+            found += hashTable.search(op.key).size();
+        } else {
+            hashTable.remove(op.key);
+        }
+        if (latencies) {
+            (*latencies)[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - before).count();
+        }
+    }
+    // Не даем компилятору выбросить поиск
+    volatile size_t sink = found;
+    (void)sink;
+}
+
+// Два прогона на свежих таблицах: без замеров отдельных операций (пропускная
+// способность и память) и с ними (процентили задержек)
+template <typename Table>
+WorkloadResult runWorkload(const string& name, const vector<int>& prefill, const vector<WorkloadOp>& ops) {
+    WorkloadResult result;
+    result.table = name;
+    {
+        malloc_trim(0);
+        size_t residentBefore = residentBytes();
+        Table hashTable;
+        hashTable.verbose = false;
+        for (int key : prefill) hashTable.insert(key, "value");
+        auto start = chrono::steady_clock::now();
+        applyWorkload(hashTable, ops, nullptr);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.opsPerSecond = ops.size() / seconds;
+        result.memoryBytes = static_cast<long long>(residentBytes()) - static_cast<long long>(residentBefore);
+        result.rehashCount = hashTable.rehashCount;
+        result.size = tableSize(hashTable);
+        lookupLengths(hashTable, result.avgLookup, result.maxLookup);
+    }
+    {
+        Table hashTable;
+        hashTable.verbose = false;
+        for (int key : prefill) hashTable.insert(key, "value");
+        vector<double> latencies(ops.size());
+        applyWorkload(hashTable, ops, &latencies);
+        result.maxLatency = *max_element(latencies.begin(), latencies.end());
+        result.p50 = latencyPercentile(latencies, 0.5);
+        result.p99 = latencyPercentile(latencies, 0.99);
+        result.p999 = latencyPercentile(latencies, 0.999);
+    }
+    return result;
+}
+
+int runWorkloadBenchmark(const WorkloadConfig& config) {
+    mt19937 generator(config.seed);
+    KeyGenerator nextKey(config);
+    int prefillCount = config.prefill >= 0 ? config.prefill : config.keySpace / 2;
+    vector<int> prefill(prefillCount);
+    for (int& key : prefill) key = nextKey(generator);
+    
+    vector<WorkloadOp> ops(config.operations);
+    uniform_int_distribution<int> percent(0, 99);
+    for (WorkloadOp& op : ops) {
+        int roll = percent(generator);
+        if (roll < config.insertPercent) {
+            op.type = WorkloadOp::INSERT;
+        } else if (roll < config.insertPercent + config.searchPercent) {
+            op.type = WorkloadOp::SEARCH;
+        } else {
+            op.type = WorkloadOp::REMOVE;
+        }
+        op.key = nextKey(generator);
+    }
+    
+    vector<WorkloadResult> results;
+    results.push_back(runWorkload<OpenAddressingHashTable>("open_addressing", prefill, ops));
+    results.push_back(runWorkload<PowerOfTwoHashTable>("open_addressing_pow2", prefill, ops));
+    results.push_back(runWorkload<ChainingHashTable>("chaining", prefill, ops));
+    results.push_back(runWorkload<PooledChainingHashTable>("pooled_chaining", prefill, ops));
+    results.push_back(runWorkload<CuckooHashTable>("cuckoo", prefill, ops));
+    results.push_back(runWorkload<StdHashTable>("std_unordered_map", prefill, ops));
+    
+    cout << "{\n  \"workload\": {\"distribution\": \"" << config.distribution << "\", \"keys\": " << config.keySpace
+         << ", \"prefill\": " << prefillCount << ", \"operations\": " << config.operations
+         << ", \"mix\": {\"insert\": " << config.insertPercent << ", \"search\": " << config.searchPercent
+         << ", \"remove\": " << config.removePercent << "}";
+    if (config.distribution == "zipf") {
+        cout << ", \"zipf_exponent\": " << config.zipfExponent;
+    }
+    cout << ", \"seed\": " << config.seed << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const WorkloadResult& r = results[i];
+        cout << "    {\"table\": \"" << r.table << "\", \"ops_per_sec\": " << r.opsPerSecond
+             << ", \"latency_ns\": {\"p50\": " << r.p50 << ", \"p99\": " << r.p99 << ", \"p999\": " << r.p999
+             << ", \"max\": " << r.maxLatency << "}, \"memory_bytes\": " << r.memoryBytes
+             << ", \"rehash_count\": " << r.rehashCount << ", \"size\": " << r.size
+             << ", \"avg_lookup_length\": " << r.avgLookup << ", \"max_lookup_length\": " << r.maxLookup << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    cout << "  ]\n}" << endl;
+    return 0;
+}
+
+// Потокобезопасная таблица с цепочками: ключи распределяются по независимым сегментам
+// (старшие биты перемешанного ключа), у каждого сегмента своя таблица и своя блокировка
+// читателей-писателя. Поиск берет разделяемую блокировку одного сегмента, вставка и
+// удаление - исключительную; реструктуризация идет внутри сегмента и не останавливает
+// остальные
+struct alignas(64) ConcurrentShard {
+    shared_mutex lock;
+    ChainingHashTable table;
+};
+
+struct ConcurrentChainingHashTable {
+    vector<ConcurrentShard> shards;
+    int shardBits;
+
+    ConcurrentChainingHashTable(int shardCount = 64) : shards(1), shardBits(0) {
+        while ((1 << shardBits) < shardCount) shardBits++;
+        vector<ConcurrentShard>(static_cast<size_t>(1) << shardBits).swap(shards);
+        for (ConcurrentShard& shard : shards) {
+            shard.table.verbose = false;
+        }
+    }
+
+    ConcurrentShard& shardOf(int key) {
+        return shardBits == 0 ? shards[0] : shards[mixKey(key) >> (64 - shardBits)];
+    }
+
+    void insert(int key, const string& value) {
+        ConcurrentShard& shard = shardOf(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        shard.table.insert(key, value);
+    }
+
+    string search(int key) {
+        ConcurrentShard& shard = shardOf(key);
+        shared_lock<shared_mutex> guard(shard.lock);
+        return shard.table.search(key);
+    }
+
+    void remove(int key) {
+        ConcurrentShard& shard = shardOf(key);
+        unique_lock<shared_mutex> guard(shard.lock);
+        shard.table.remove(key);
+    }
+
+    // Вывод статистики (сегменты блокируются по очереди)
+    void printStats() {
+        long long size = 0;
+        int rehashCount = 0, minShard = INT_MAX, maxShard = 0;
+        for (ConcurrentShard& shard : shards) {
+            shared_lock<shared_mutex> guard(shard.lock);
+            size += shard.table.size;
+            rehashCount += shard.table.rehashCount;
+            minShard = min(minShard, shard.table.size);
+            maxShard = max(maxShard, shard.table.size);
+        }
+        cout << "\nСтатистика сегментированной таблицы с цепочками" << endl;
+        cout << "Размер: " << size << endl;
+        cout << "Сегментов: " << shards.size() << endl;
+        cout << "Элементов в сегменте: от " << minShard << " до " << maxShard << endl;
+        cout << "Количество реструктуризаций (всех сегментов): " << rehashCount << endl;
+    }
+};
+
+// Масштабирование по потокам: 99% поисков и 1% вставок по случайным ключам,
+// одна блокировка на всю таблицу против сегментов
+int runThreadScalingBenchmark(int count) {
+    int maxThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+    const long long totalOps = 4000000;
+    
+    cout << "Ключей: " << count << ", операций: " << totalOps << " (99% поиск, 1% вставка), ядер: " << maxThreads << endl;
+    for (int shardCount : {1, 64}) {
+        ConcurrentChainingHashTable hashTable(shardCount);
+        for (int i = 0; i < count; i++) {
+            hashTable.insert(i, "value");
+        }
+        for (int threads : threadCounts) {
+            vector<thread> workers;
+            atomic<size_t> found(0);
+            auto start = chrono::steady_clock::now();
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    mt19937 generator(1000 + t);
+                    size_t localFound = 0;
+                    for (long long i = 0; i < totalOps / threads; i++) {
+                        int key = static_cast<int>(generator() % (2 * static_cast<unsigned>(count)));
+                        if (i % 100 == 0) {
+                            hashTable.insert(key, "value");
+                        } else {
+                            localFound += hashTable.search(key) != "Not Found";
+                        }
+                    }
+                    found += localFound;
+                });
+            }
+            for (thread& worker : workers) worker.join();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << (shardCount == 1 ? "Одна блокировка" : "Сегментов 64") << ", потоков " << threads << ": "
+                 << (totalOps / threads) * threads / seconds << " оп/с (найдено " << found << ")" << endl;
+        }
+    }
+    return 0;
+}
+
+void printUsage(const string& programName) {
+    cerr << "Использование: " << programName << " [--incremental] [--pow2] [--bench-rehash <число вставок>]" << endl;
+    cerr << "       " << programName << " --bench-churn <число ключей> | --bench-hash <число ключей>" << endl;
+    cerr << "       " << programName << " --bench-pool <число ключей>" << endl;
+    cerr << "  --incremental   переносить элементы при реструктуризации постепенно" << endl;
+    cerr << "  --pow2          открытая адресация с емкостью степени двойки и перемешиванием ключа" << endl;
+    cerr << "  --bench-rehash  сравнить задержки вставки при полной и постепенной реструктуризации" << endl;
+    cerr << "  --bench-churn   длина проб при постоянных удалениях и вставках" << endl;
+    cerr << "  --bench-hash    сравнить индексацию делением и маской на разных ключах" << endl;
+    cerr << "  --bench-pool    сравнить память и поиск цепочек на указателях и в пуле" << endl;
+    cerr << "       " << programName << " --bench-threads <число ключей>" << endl;
+    cerr << "  --bench-threads масштабирование сегментированной таблицы с цепочками по потокам" << endl;
+    cerr << "       " << programName << " --workload [--dist uniform|sequential|zipf] [--keys <число>] [--ops <число>]" << endl;
+    cerr << "                 [--prefill <число>] [--mix <вставка:поиск:удаление в %>] [--zipf <показатель>] [--seed <число>]" << endl;
+    cerr << "  --workload      одинаковая нагрузка на все таблицы, результат в JSON" << endl;
+    cerr << "       " << programName << " --build-snapshot <файл> --entries <число>" << endl;
+    cerr << "       " << programName << " --snapshot <файл> [--ops <число запросов>]" << endl;
+    cerr << "  --build-snapshot  записать снимок с синтетическими элементами" << endl;
+    cerr << "  --snapshot        отобразить снимок в память и искать ключи из stdin (или замерить --ops запросов)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string mode;
+    int benchCount = 0;
+    bool incremental = false;
+    bool powerOfTwo = false;
+    WorkloadConfig workload;
+    string snapshotFile;
+    int snapshotEntries = 0;
+    bool lookupsGiven = false;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--incremental") {
+            incremental = true;
+        } else if (arg == "--pow2") {
+            powerOfTwo = true;
+        } else if (arg == "--workload") {
+            mode = arg;
+        } else if ((arg == "--build-snapshot" || arg == "--snapshot") && i + 1 < argc) {
+            mode = arg;
+            snapshotFile = argv[++i];
+        } else if (arg == "--entries" && i + 1 < argc) {
+            snapshotEntries = atoi(argv[++i]);
+        } else if (arg == "--dist" && i + 1 < argc) {
+            workload.distribution = argv[++i];
+        } else if (arg == "--keys" && i + 1 < argc) {
+            workload.keySpace = atoi(argv[++i]);
+        } else if (arg == "--ops" && i + 1 < argc) {
+            workload.operations = atoi(argv[++i]);
+            lookupsGiven = true;
+        } else if (arg == "--prefill" && i + 1 < argc) {
+            workload.prefill = atoi(argv[++i]);
+        } else if (arg == "--zipf" && i + 1 < argc) {
+            workload.zipfExponent = atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            workload.seed = static_cast<unsigned>(atol(argv[++i]));
+        } else if (arg == "--mix" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d:%d:%d", &workload.insertPercent, &workload.searchPercent,
+                       &workload.removePercent) != 3) {
+                cerr << "Ошибка: формат --mix: вставка:поиск:удаление, например 50:40:10" << endl;
+                return 1;
+            }
+        } else if ((arg == "--bench-rehash" || arg == "--bench-churn" || arg == "--bench-hash" ||
+                    arg == "--bench-pool" || arg == "--bench-threads") && i + 1 < argc) {
+            mode = arg;
+            benchCount = atoi(argv[++i]);
+        } else {
+            cerr << "Ошибка: неизвестный аргумент: " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (mode == "--build-snapshot") {
+        if (snapshotEntries <= 0) {
+            cerr << "Ошибка: число элементов (--entries) должно быть положительным" << endl;
+            return 1;
+        }
+        return runBuildSnapshot(snapshotFile, snapshotEntries);
+    }
+    if (mode == "--snapshot") {
+        return runSnapshotMode(snapshotFile, lookupsGiven ? workload.operations : 0);
+    }
+    if (mode == "--workload") {
+        if (workload.distribution != "uniform" && workload.distribution != "sequential" &&
+            workload.distribution != "zipf") {
+            cerr << "Ошибка: неизвестное распределение ключей: " << workload.distribution << endl;
+            return 1;
+        }
+        if (workload.keySpace <= 0 || workload.operations <= 0 || workload.insertPercent < 0 ||
+            workload.searchPercent < 0 || workload.removePercent < 0 ||
+            workload.insertPercent + workload.searchPercent + workload.removePercent != 100) {
+            cerr << "Ошибка: число ключей и операций должно быть положительным, а доли операций - давать 100%" << endl;
+            return 1;
+        }
+        return runWorkloadBenchmark(workload);
+    }
+    if (!mode.empty()) {
+        if (benchCount <= 0) {
+            cerr << "Ошибка: число ключей должно быть положительным" << endl;
+            return 1;
+        }
+        if (mode == "--bench-rehash") {
+            return runRehashBenchmark(benchCount);
+        }
+        if (mode == "--bench-pool") {
+            return runPoolBenchmark(benchCount);
+        }
+        if (mode == "--bench-threads") {
+            return runThreadScalingBenchmark(benchCount);
+        }
+        return mode == "--bench-churn" ? runChurnBenchmark(benchCount) : runHashBenchmark(benchCount);
+    }
+    
     cout << "Хеш-таблицы с собственными структурами" << endl;
     
-    interactiveMode();
+    interactiveMode(incremental, powerOfTwo);
     
     return 0;
-}
\ No newline at end of file
+}